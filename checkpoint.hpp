@@ -0,0 +1,333 @@
+#pragma once
+#include "life_accel.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//
+// ---------- Incremental Checkpoints ----------
+//
+// A checkpoint directory holds a full base snapshot (base-<gen>.snap) and
+// delta.log, an append-only log of 64x64 tiles that differ from the state
+// of the previous checkpoint. Tiles are one snapshot word per row, so a
+// tile is 64 words at a fixed word column.
+//
+// delta.log starts with two header slots. A checkpoint appends its record,
+// fsyncs, then writes the other slot with a higher sequence number and the
+// new committed length, and fsyncs again. Readers take the valid slot with
+// the highest sequence number and ignore anything past its committed
+// length, so a crash at any point leaves the previous checkpoint intact.
+// When the log outgrows the base, the next checkpoint writes a new base and
+// commits headers pointing at it with an empty log before dropping the old
+// base.
+//
+struct CheckpointHeader {
+    char magic[8];
+    uint64_t seq;
+    int64_t generation;
+    int64_t baseGen;
+    uint64_t committed;  // log bytes covered by this header
+    uint32_t cols, rows;
+    uint64_t checksum;   // of all fields above
+};
+
+struct DeltaRecordHeader {
+    uint32_t magic;
+    uint32_t tiles;
+    int64_t generation;
+    uint64_t checksum;   // of the tile payload
+};
+
+struct DeltaTile {
+    uint32_t ty, tx;
+    uint64_t words[64];
+};
+
+constexpr char kCheckpointMagic[8] = {'L', 'I', 'F', 'E', 'C', 'K', 'P', '1'};
+constexpr uint32_t kDeltaMagic = 0x41544c44;  // "DLTA"
+constexpr uint64_t kHeaderSlot = 64;
+constexpr uint64_t kLogStart = 2 * kHeaderSlot;
+
+inline uint64_t fnv1a(const void *data, size_t n, uint64_t h = 0xcbf29ce484222325ull) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+inline uint64_t headerChecksum(const CheckpointHeader &h) {
+    return fnv1a(&h, offsetof(CheckpointHeader, checksum));
+}
+
+inline bool syncFile(FILE *f) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+// Makes a rename inside `dir` durable; NTFS journals renames itself.
+inline void syncDir(const std::string &dir) {
+#ifndef _WIN32
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)dir;
+#endif
+}
+
+// fseek with 64-bit offsets; logs of large boards pass 2 GB.
+inline bool seekFile(FILE *f, uint64_t pos) {
+#ifdef _WIN32
+    return _fseeki64(f, (long long)pos, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)pos, SEEK_SET) == 0;
+#endif
+}
+
+// Newest valid header of a log, or false if neither slot is valid.
+inline bool readCheckpointHeader(FILE *f, CheckpointHeader &out) {
+    bool found = false;
+    for (uint64_t slot = 0; slot < 2; ++slot) {
+        CheckpointHeader h{};
+        if (!seekFile(f, slot * kHeaderSlot) || fread(&h, sizeof h, 1, f) != 1) continue;
+        if (std::memcmp(h.magic, kCheckpointMagic, 8) != 0 || h.checksum != headerChecksum(h)) continue;
+        if (!found || h.seq > out.seq) out = h;
+        found = true;
+    }
+    return found;
+}
+
+class Checkpointer {
+public:
+    ~Checkpointer() {
+        if (log) fclose(log);
+    }
+
+    // Starts a new chain in `dir`; the first checkpoint writes a full base.
+    bool open(const std::string &dir, int rows, int cols, std::string *error = nullptr) {
+        namespace fs = std::filesystem;
+        this->dir = dir;
+        this->rows = rows;
+        this->cols = cols;
+        wordsPerRow = (cols + 63) / 64;
+        tileRows = (rows + 63) / 64;
+        shadow.assign((size_t)rows * wordsPerRow, 0);
+        haveBase = false;
+
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        std::string path = logPath();
+        log = fopen(path.c_str(), "r+b");
+        if (!log) log = fopen(path.c_str(), "w+b");
+        if (!log) return fail(error, "cannot open " + path);
+        // keep numbering above the chain already here so ours wins once committed
+        CheckpointHeader h{};
+        if (readCheckpointHeader(log, h)) {
+            seq = h.seq;
+            prevBase = h.baseGen;
+        }
+        return true;
+    }
+
+    // Writes tiles changed since the last checkpoint, or a new base when
+    // none exists yet or the log has grown past the size of one.
+    bool checkpoint(const LifeAccel &life, long long gen, std::string *error = nullptr) {
+        if (!log) return fail(error, "checkpointer not open");
+        std::vector<DeltaTile> dirty;
+        collectDirty(life, dirty);
+        lastTiles = dirty.size();
+
+        // The shadow only takes the new state once it is committed. After a
+        // failure the log may hold part of a record, or one header may name
+        // a new base, so the next checkpoint starts over with a full base.
+        uint64_t baseBytes = sizeof(SnapshotHeader) + shadow.size() * 8;
+        if (!haveBase || forceBase || committed + dirty.size() * sizeof(DeltaTile) > baseBytes) {
+            forceBase = !writeBase(gen, dirty, error);
+            if (!forceBase) shadowBox = life.getBounds();
+            return !forceBase;
+        }
+
+        DeltaRecordHeader rh{kDeltaMagic, (uint32_t)dirty.size(), gen,
+                             fnv1a(dirty.data(), dirty.size() * sizeof(DeltaTile))};
+        if (!seekFile(log, committed) ||
+            fwrite(&rh, sizeof rh, 1, log) != 1 ||
+            (!dirty.empty() && fwrite(dirty.data(), sizeof(DeltaTile), dirty.size(), log) != dirty.size()) ||
+            !syncFile(log)) {
+            forceBase = true;
+            return fail(error, "cannot append to " + logPath());
+        }
+        if (!commit(gen, baseGen, committed + sizeof rh + dirty.size() * sizeof(DeltaTile), error)) {
+            forceBase = true;
+            return false;
+        }
+        applyDirty(shadow, dirty);
+        shadowBox = life.getBounds();
+        return true;
+    }
+
+    // Loads the base named by the newest valid header and replays the log.
+    static bool restore(const std::string &dir, LifeAccel &life, long long *gen, std::string *error = nullptr) {
+        std::string logFile = dir + "/delta.log";
+        FILE *f = fopen(logFile.c_str(), "rb");
+        if (!f) return fail(error, "cannot open " + logFile);
+        CheckpointHeader h{};
+        bool ok = readCheckpointHeader(f, h);
+        if (!ok) {
+            fclose(f);
+            return fail(error, logFile + ": no valid header");
+        }
+        if (!life.loadSnapshot(basePath(dir, h.baseGen), error)) {
+            fclose(f);
+            return false;
+        }
+
+        uint8_t *cells = life.cells();
+        int rows = life.getRows(), cols = life.getCols();
+        uint64_t pos = kLogStart;
+        std::vector<DeltaTile> tiles;
+        seekFile(f, pos);
+        while (pos < h.committed) {
+            DeltaRecordHeader rh;
+            if (fread(&rh, sizeof rh, 1, f) != 1 || rh.magic != kDeltaMagic) { ok = false; break; }
+            tiles.resize(rh.tiles);
+            if ((rh.tiles && fread(tiles.data(), sizeof(DeltaTile), rh.tiles, f) != rh.tiles) ||
+                fnv1a(tiles.data(), tiles.size() * sizeof(DeltaTile)) != rh.checksum) { ok = false; break; }
+            for (const DeltaTile &t : tiles)
+                for (int r = 0; r < 64 && (int)t.ty * 64 + r < rows; ++r)
+                    for (int b = 0; b < 64 && (int)t.tx * 64 + b < cols; ++b)
+                        cells[(size_t)(t.ty * 64 + r) * cols + t.tx * 64 + b] = (t.words[r] >> b) & 1;
+            pos += sizeof rh + tiles.size() * sizeof(DeltaTile);
+        }
+        fclose(f);
+        if (!ok) return fail(error, logFile + ": committed record unreadable");
+        if (gen) *gen = h.generation;
+        return true;
+    }
+
+    size_t getLastTiles() const { return lastTiles; }
+    uint64_t getLogBytes() const { return committed; }
+
+private:
+    std::string dir;
+    FILE *log = nullptr;
+    int rows = 0, cols = 0, tileRows = 0;
+    size_t wordsPerRow = 0;
+    std::vector<uint64_t> shadow;  // bit-packed state of the last checkpoint
+    bool haveBase = false, forceBase = false;
+    uint64_t seq = 0, committed = kLogStart;
+    int64_t baseGen = -1, prevBase = -1;
+    size_t lastTiles = 0;
+    CellBox shadowBox;  // live cells at the last checkpoint
+
+    static bool fail(std::string *error, const std::string &msg) {
+        if (error) *error = msg;
+        return false;
+    }
+    std::string logPath() const { return dir + "/delta.log"; }
+    static std::string basePath(const std::string &dir, int64_t gen) {
+        return dir + "/base-" + std::to_string(gen) + ".snap";
+    }
+
+    // Packs the board into snapshot words and diffs it against the shadow,
+    // one 64-row band at a time. Bands dead now and at the last checkpoint
+    // are skipped without packing, and only cells inside either live box are
+    // read, so cold pages stay packed. The shadow itself is left alone.
+    void collectDirty(const LifeAccel &life, std::vector<DeltaTile> &dirty) const {
+        CellBox box = life.getBounds();
+        box.add(shadowBox);
+        const uint8_t *cells = life.cellsIn(box);
+        std::vector<uint64_t> band(64 * wordsPerRow);
+        for (int ty = 0; ty < tileRows; ++ty) {
+            int r0 = ty * 64, r1 = std::min(rows, r0 + 64);
+            if (box.empty() || r1 <= box.top || r0 > box.bottom) continue;
+            std::fill(band.begin(), band.end(), 0);
+            for (int r = std::max(r0, box.top); r < r1 && r <= box.bottom; ++r) {
+                const uint8_t *row = cells + (size_t)r * cols;
+                uint64_t *w = &band[(size_t)(r - r0) * wordsPerRow];
+                for (int c = box.left; c <= box.right; ++c) w[c >> 6] |= (uint64_t)row[c] << (c & 63);
+            }
+            for (size_t tx = 0; tx < wordsPerRow; ++tx) {
+                bool differs = false;
+                for (int r = r0; r < r1 && !differs; ++r)
+                    differs = band[(size_t)(r - r0) * wordsPerRow + tx] != shadow[(size_t)r * wordsPerRow + tx];
+                if (!differs) continue;
+                DeltaTile t{(uint32_t)ty, (uint32_t)tx, {}};
+                for (int r = r0; r < r1; ++r) t.words[r - r0] = band[(size_t)(r - r0) * wordsPerRow + tx];
+                dirty.push_back(t);
+            }
+        }
+    }
+
+    void applyDirty(std::vector<uint64_t> &words, const std::vector<DeltaTile> &dirty) const {
+        for (const DeltaTile &t : dirty)
+            for (int r = 0; r < 64 && (int)t.ty * 64 + r < rows; ++r)
+                words[(size_t)(t.ty * 64 + r) * wordsPerRow + t.tx] = t.words[r];
+    }
+
+    // Writes the shadow plus `dirty` as a new base and, once both headers
+    // point at it, makes that the shadow.
+    bool writeBase(long long gen, const std::vector<DeltaTile> &dirty, std::string *error) {
+        namespace fs = std::filesystem;
+        std::vector<uint64_t> fresh = shadow;
+        applyDirty(fresh, dirty);
+        std::string path = basePath(dir, gen), tmp = path + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        if (!f) return fail(error, "cannot write " + tmp);
+        SnapshotHeader sh = makeSnapshotHeader(rows, cols);
+        bool ok = fwrite(&sh, sizeof sh, 1, f) == 1 &&
+                  fwrite(fresh.data(), 8, fresh.size(), f) == fresh.size() && syncFile(f);
+        fclose(f);
+        std::error_code ec;
+        if (ok) fs::rename(tmp, path, ec);
+        if (!ok || ec) return fail(error, "cannot write " + path);
+        syncDir(dir);
+
+        // commit into both slots, so neither header references the old base
+        // or log tail by the time they are removed
+        int64_t oldBase = haveBase ? baseGen : prevBase;
+        if (!commit(gen, gen, kLogStart, error) || !commit(gen, gen, kLogStart, error)) return false;
+        haveBase = true;
+        shadow.swap(fresh);
+        if (oldBase >= 0 && oldBase != gen) fs::remove(basePath(dir, oldBase), ec);
+        fflush(log);
+        fs::resize_file(logPath(), kLogStart, ec);
+        return true;
+    }
+
+    bool commit(long long gen, int64_t base, uint64_t length, std::string *error) {
+        CheckpointHeader h{};
+        std::memcpy(h.magic, kCheckpointMagic, 8);
+        h.seq = seq + 1;
+        h.generation = gen;
+        h.baseGen = base;
+        h.committed = length;
+        h.cols = cols;
+        h.rows = rows;
+        h.checksum = headerChecksum(h);
+        if (!seekFile(log, (h.seq % 2) * kHeaderSlot) ||
+            fwrite(&h, sizeof h, 1, log) != 1 || !syncFile(log))
+            return fail(error, "cannot commit header of " + logPath());
+        seq = h.seq;
+        baseGen = base;
+        committed = length;
+        return true;
+    }
+};
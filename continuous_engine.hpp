@@ -0,0 +1,470 @@
+#pragma once
+#include "life_accel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//
+// ---------- FFT ----------
+//
+// Iterative radix-2 complex FFT of one power-of-two length. The
+// bit-reversal permutation and twiddles are computed once, in double.
+// Products are written out by hand, because std::complex multiplication
+// goes through a NaN-checking library call unless -ffast-math is on.
+//
+// A length whose prime factors are all small (640 = 4^3 * 2 * 5, 360 =
+// 4 * 2 * 3^2 * 5) is split mixed-radix: recursive decimation in time, with
+// a plain DFT butterfly of each radix over the sub-transforms, as in
+// KISS FFT. Any other length n goes through Bluestein's chirp-z: with
+// w_k = exp(-i pi k^2 / n), X_k = w_k * sum_j (x_j w_j) conj(w_{k-j}), a
+// circular convolution done by a power-of-two FFT of length m >= 2n - 1
+// against the chirp's spectrum, which is computed once. That costs about
+// three transforms of length m, but either way the board keeps its exact
+// size, so the torus wraps where the caller asked.
+//
+using cfloat = std::complex<float>;
+
+class Fft {
+public:
+    explicit Fft(size_t n = 1) : n(n) {
+        if (n & (n - 1)) {
+            if (!factorSmall()) initChirp();
+            return;
+        }
+        rev.resize(n);
+        tw.resize(n / 2);
+        int bits = 0;
+        while (((size_t)1 << bits) < n) ++bits;
+        for (size_t i = 0; i < n; ++i) {
+            size_t r = 0;
+            for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1) << (bits - 1 - b);
+            rev[i] = (uint32_t)r;
+        }
+        for (size_t k = 0; k < n / 2; ++k) {
+            double a = -2 * 3.14159265358979323846 * (double)k / (double)n;
+            tw[k] = cfloat((float)std::cos(a), (float)std::sin(a));
+        }
+    }
+
+    size_t size() const { return n; }
+
+    // In place; the inverse is unnormalized (scaled by n).
+    void transform(cfloat *a, bool inverse) const {
+        if (inner) {
+            chirpTransform(a, inverse);
+            return;
+        }
+        if (!radix.empty()) {
+            // the inverse is the forward transform of the conjugate, conjugated
+            static thread_local std::vector<cfloat> in;
+            in.resize(n);
+            for (size_t k = 0; k < n; ++k) in[k] = inverse ? std::conj(a[k]) : a[k];
+            mixedRadix(in.data(), 1, a, n, 0);
+            if (inverse)
+                for (size_t k = 0; k < n; ++k) a[k] = std::conj(a[k]);
+            return;
+        }
+        for (size_t i = 0; i < n; ++i)
+            if (i < rev[i]) std::swap(a[i], a[rev[i]]);
+        const float sign = inverse ? -1.f : 1.f;
+        for (size_t len = 2; len <= n; len <<= 1) {
+            const size_t half = len / 2, step = n / len;
+            for (size_t i = 0; i < n; i += len)
+                for (size_t j = 0; j < half; ++j) {
+                    const cfloat w = tw[j * step];
+                    const float wr = w.real(), wi = sign * w.imag();
+                    cfloat &x = a[i + j], &y = a[i + j + half];
+                    const float vr = y.real() * wr - y.imag() * wi, vi = y.real() * wi + y.imag() * wr;
+                    y = cfloat(x.real() - vr, x.imag() - vi);
+                    x = cfloat(x.real() + vr, x.imag() + vi);
+                }
+        }
+    }
+
+private:
+    size_t n;
+    std::vector<uint32_t> rev;
+    std::vector<cfloat> tw;
+    static constexpr size_t kMaxRadix = 7;
+    std::vector<size_t> radix;             // mixed-radix factors, outermost first
+    std::unique_ptr<Fft> inner;            // length m, for Bluestein
+    std::vector<cfloat> chirp, chirpSpec;  // w_k; spectrum of conj(w) wrapped, over m
+
+    static cfloat mul(cfloat x, cfloat y) {
+        return cfloat(x.real() * y.real() - x.imag() * y.imag(), x.real() * y.imag() + x.imag() * y.real());
+    }
+
+    // Splits n into radices 4, 2, 3, 5 and 7 and fills the twiddles
+    // exp(-2 pi i k / n) for all k; false if another prime divides n.
+    bool factorSmall() {
+        size_t r = n;
+        for (size_t p : {4, 2, 3, 5, 7})
+            while (r % p == 0) {
+                radix.push_back(p);
+                r /= p;
+            }
+        if (r != 1) {
+            radix.clear();
+            return false;
+        }
+        tw.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            double a = -2 * 3.14159265358979323846 * (double)k / (double)n;
+            tw[k] = cfloat((float)std::cos(a), (float)std::sin(a));
+        }
+        return true;
+    }
+
+    // out[0, len) = DFT of in[0], in[stride], ... (len of them), the
+    // sub-transform at depth `level` of the factorization.
+    void mixedRadix(const cfloat *in, size_t stride, cfloat *out, size_t len, size_t level) const {
+        const size_t p = radix[level], m = len / p, step = n / len;
+        for (size_t q = 0; q < p; ++q) {
+            if (m == 1)
+                out[q] = in[q * stride];
+            else
+                mixedRadix(in + q * stride, stride * p, out + q * m, m, level + 1);
+        }
+        // X[f + s m] = sum_q w_len^(q (f + s m)) Y_q[f]
+        //            = sum_q (w_len^(q f) Y_q[f]) w_p^(q s)
+        cfloat t[kMaxRadix];
+        for (size_t f = 0; f < m; ++f) {
+            for (size_t q = 0; q < p; ++q) t[q] = q ? mul(out[q * m + f], tw[q * f * step]) : out[f];
+            if (p == 2) {
+                out[f] = t[0] + t[1];
+                out[m + f] = t[0] - t[1];
+                continue;
+            }
+            if (p == 4) {  // w_4 = -i
+                cfloat a = t[0] + t[2], b = t[0] - t[2], c = t[1] + t[3], d = t[1] - t[3];
+                cfloat di(d.imag(), -d.real());  // -i d
+                out[f] = a + c;
+                out[m + f] = b + di;
+                out[2 * m + f] = a - c;
+                out[3 * m + f] = b - di;
+                continue;
+            }
+            for (size_t s = 0; s < p; ++s) {
+                cfloat x = t[0];
+                for (size_t q = 1; q < p; ++q) x += mul(t[q], tw[(q * s % p) * (n / p)]);
+                out[s * m + f] = x;
+            }
+        }
+    }
+
+    void initChirp() {
+        size_t m = 1;
+        while (m < 2 * n - 1) m <<= 1;
+        inner = std::make_unique<Fft>(m);
+        chirp.resize(n);
+        chirpSpec.assign(m, cfloat(0, 0));
+        for (size_t k = 0; k < n; ++k) {
+            // k^2 mod 2n keeps the angle exact for large k
+            double a = -3.14159265358979323846 * (double)((k * k) % (2 * n)) / (double)n;
+            chirp[k] = cfloat((float)std::cos(a), (float)std::sin(a));
+            chirpSpec[k] = std::conj(chirp[k]);
+            if (k) chirpSpec[m - k] = std::conj(chirp[k]);
+        }
+        inner->transform(chirpSpec.data(), false);
+        const float scale = 1.f / (float)m;  // folds in the inner inverse's normalization
+        for (cfloat &c : chirpSpec) c *= scale;
+    }
+
+    // The inverse is the forward transform of the conjugate, conjugated.
+    void chirpTransform(cfloat *a, bool inverse) const {
+        static thread_local std::vector<cfloat> buf;
+        const size_t m = inner->size();
+        buf.assign(m, cfloat(0, 0));
+        for (size_t k = 0; k < n; ++k) buf[k] = mul(inverse ? std::conj(a[k]) : a[k], chirp[k]);
+        inner->transform(buf.data(), false);
+        for (size_t k = 0; k < m; ++k) buf[k] = mul(buf[k], chirpSpec[k]);
+        inner->transform(buf.data(), true);
+        for (size_t k = 0; k < n; ++k) {
+            cfloat x = mul(buf[k], chirp[k]);
+            a[k] = inverse ? std::conj(x) : x;
+        }
+    }
+};
+
+//
+// ---------- 2D Real FFT ----------
+//
+// Transforms a rows x cols real grid to its half spectrum, rows x
+// (cols / 2 + 1), the other half being its conjugate mirror. Real rows go
+// through the complex FFT in pairs, as real and imaginary parts, and are
+// separated afterwards by symmetry, so a row costs half a complex FFT; an
+// odd last row is paired with zeros. Columns of the half spectrum are then
+// transformed eight at a time, gathered into contiguous buffers. Both passes
+// are split across the pool. inverse() runs the same steps backwards and is
+// unnormalized.
+//
+class RealFft2d {
+public:
+    RealFft2d(int rows, int cols, ThreadPool &pool)
+        : rows(rows), cols(cols), half(cols / 2 + 1), rowFft(cols), colFft(rows), pool(pool) {}
+
+    int spectrumCols() const { return half; }
+
+    void forward(const float *in, cfloat *spec) {
+        parallel((rows + 1) / 2, [&](int p) {
+            static thread_local std::vector<cfloat> z;
+            z.resize(cols);
+            const bool pair = 2 * p + 1 < rows;
+            const float *a = in + (size_t)2 * p * cols, *b = a + cols;
+            for (int c = 0; c < cols; ++c) z[c] = cfloat(a[c], pair ? b[c] : 0.f);
+            rowFft.transform(z.data(), false);
+            cfloat *x1 = spec + (size_t)2 * p * half, *x2 = x1 + half;
+            for (int k = 0; k < half; ++k) {
+                cfloat zk = z[k], zn = std::conj(z[k ? cols - k : 0]);
+                x1[k] = cfloat(0.5f * (zk.real() + zn.real()), 0.5f * (zk.imag() + zn.imag()));
+                if (pair)
+                    x2[k] = cfloat(0.5f * (zk.imag() - zn.imag()), -0.5f * (zk.real() - zn.real()));  // (zk - zn) / 2i
+            }
+        });
+        columns(spec, false);
+    }
+
+    // Overwrites `spec`.
+    void inverse(cfloat *spec, float *out) {
+        columns(spec, true);
+        parallel((rows + 1) / 2, [&](int p) {
+            static thread_local std::vector<cfloat> z;
+            z.resize(cols);
+            const bool pair = 2 * p + 1 < rows;
+            const cfloat *x1 = spec + (size_t)2 * p * half, *x2 = x1 + half;
+            for (int k = 0; k < cols; ++k) {
+                cfloat a = k < half ? x1[k] : std::conj(x1[cols - k]);
+                cfloat b = !pair ? cfloat(0, 0) : k < half ? x2[k] : std::conj(x2[cols - k]);
+                z[k] = cfloat(a.real() - b.imag(), a.imag() + b.real());  // a + i b
+            }
+            rowFft.transform(z.data(), true);
+            float *a = out + (size_t)2 * p * cols, *b = a + cols;
+            for (int c = 0; c < cols; ++c) {
+                a[c] = z[c].real();
+                if (pair) b[c] = z[c].imag();
+            }
+        });
+    }
+
+    // Runs fn(i) for i in [0, n) on the pool, in a few contiguous chunks per
+    // worker.
+    template <class Fn>
+    void parallel(int n, Fn fn) {
+        const int chunks = std::min(n, std::max(1, (int)pool.size() * 4));
+        for (int k = 0; k < chunks; ++k)
+            pool.enqueue([&, k] {
+                for (int i = n * k / chunks; i < n * (k + 1) / chunks; ++i) fn(i);
+            });
+        pool.waitAll();
+    }
+
+private:
+    static constexpr int kColumnBlock = 8;  // columns per gather: 64 bytes of each row
+    int rows, cols, half;
+    Fft rowFft, colFft;
+    ThreadPool &pool;
+
+    void columns(cfloat *spec, bool inverse) {
+        parallel((half + kColumnBlock - 1) / kColumnBlock, [&](int blk) {
+            static thread_local std::vector<cfloat> buf;
+            const int k0 = blk * kColumnBlock, nk = std::min(kColumnBlock, half - k0);
+            buf.resize((size_t)kColumnBlock * rows);
+            for (int r = 0; r < rows; ++r)
+                for (int j = 0; j < nk; ++j) buf[(size_t)j * rows + r] = spec[(size_t)r * half + k0 + j];
+            for (int j = 0; j < nk; ++j) colFft.transform(&buf[(size_t)j * rows], inverse);
+            for (int r = 0; r < rows; ++r)
+                for (int j = 0; j < nk; ++j) spec[(size_t)r * half + k0 + j] = buf[(size_t)j * rows + r];
+        });
+    }
+};
+
+//
+// ---------- Continuous Engine ----------
+//
+// Lenia and SmoothLife: each cell holds a float in [0, 1], and the next
+// state depends on weighted sums over discs and rings many cells across.
+// Those sums are convolutions on the torus, done as a product of spectra:
+// one forward FFT of the board, then per kernel a product with the
+// kernel's spectrum and one inverse FFT. A step costs O(N log N) whatever
+// the radius. Kernel spectra are computed once per shape and board size
+// and cached, normalization included, so changing growth parameters is
+// free and going back to an earlier kernel costs nothing.
+//
+//   Lenia:      one smooth ring kernel K; A += dt * (2 exp(-(U - mu)^2 /
+//               2 sigma^2) - 1), clipped to [0, 1].
+//   SmoothLife: inner disc (radius / 3) mean m and outer ring mean n; the
+//               next state is Rafler's sigmoid transition s(n, m).
+//
+// Any board size works and wraps at exactly that size. Powers of two are
+// fastest per cell; small-prime lengths cost a few times more (640 x 360
+// steps in about the time 1024 x 512 does), and others, via Bluestein, more
+// again.
+//
+enum class ContinuousRule { Lenia, SmoothLife };
+
+struct ContinuousParams {
+    ContinuousRule rule = ContinuousRule::Lenia;
+    float radius = 13;  // kernel radius in cells
+    // Lenia (defaults: Orbium)
+    float mu = 0.15f, sigma = 0.015f, dt = 0.1f;
+    // SmoothLife birth / death intervals and sigmoid widths
+    float b1 = 0.278f, b2 = 0.365f, d1 = 0.267f, d2 = 0.445f, alphaN = 0.028f, alphaM = 0.147f;
+};
+
+class ContinuousLife {
+public:
+    ContinuousLife(int cols, int rows, ThreadPool &pool, const ContinuousParams &params = {})
+        : rows(std::max(1, rows)), cols(std::max(1, cols)), fft(this->rows, this->cols, pool),
+          cells((size_t)this->rows * this->cols, 0.f) {
+        const size_t n = (size_t)this->rows * fft.spectrumCols();
+        boardSpec.resize(n);
+        scratch.resize(n);
+        setParams(params);
+    }
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    float *data() { return cells.data(); }
+    const float *data() const { return cells.data(); }
+    const ContinuousParams &getParams() const { return params; }
+    long long getGeneration() const { return generation; }
+    double getStepMs() const { return stepMs; }
+    size_t getCachedKernels() const { return cache.size(); }
+
+    void setParams(const ContinuousParams &p) {
+        params = p;
+        kernels.clear();
+        if (p.rule == ContinuousRule::Lenia) {
+            kernels.push_back(&spectrum("ring", p.radius, [](float r) {
+                return r > 0 && r < 1 ? std::exp(4 - 1 / (r * (1 - r))) : 0.f;
+            }));
+        } else {
+            // anti-aliased over one cell at each edge
+            const float ri = p.radius / 3, ra = p.radius;
+            kernels.push_back(&spectrum("disc", ri, [=](float r) {
+                return std::clamp(ri + 0.5f - r * ri, 0.f, 1.f);
+            }));
+            kernels.push_back(&spectrum("ring/3", ra, [=](float r) {
+                float d = r * ra;
+                return std::clamp(d - ri + 0.5f, 0.f, 1.f) * std::clamp(ra + 0.5f - d, 0.f, 1.f);
+            }));
+        }
+        potential.resize(kernels.size());
+        for (auto &u : potential) u.assign(cells.size(), 0.f);
+    }
+
+    // Random blobs: `count` squares of side 2 * radius filled with noise.
+    void seed(std::mt19937 &rng, int count) {
+        std::fill(cells.begin(), cells.end(), 0.f);
+        std::uniform_real_distribution<float> u(0, 1);
+        const int side = std::max(2, (int)(2 * params.radius));
+        for (int b = 0; b < count; ++b) {
+            int top = (int)(rng() % rows), left = (int)(rng() % cols);
+            for (int i = 0; i < side; ++i)
+                for (int j = 0; j < side; ++j)
+                    cells[(size_t)((top + i) % rows) * cols + (left + j) % cols] = u(rng);
+        }
+    }
+
+    void step() {
+        auto t0 = std::chrono::steady_clock::now();
+        fft.forward(cells.data(), boardSpec.data());
+        const int half = fft.spectrumCols();
+        for (size_t k = 0; k < kernels.size(); ++k) {
+            const cfloat *ks = kernels[k]->data();
+            fft.parallel(rows, [&](int r) {
+                const size_t o = (size_t)r * half;
+                for (int c = 0; c < half; ++c) {
+                    cfloat a = boardSpec[o + c], b = ks[o + c];
+                    scratch[o + c] = cfloat(a.real() * b.real() - a.imag() * b.imag(),
+                                            a.real() * b.imag() + a.imag() * b.real());
+                }
+            });
+            fft.inverse(scratch.data(), potential[k].data());
+        }
+
+        const ContinuousParams p = params;
+        fft.parallel(rows, [&](int r) {
+            float *a = &cells[(size_t)r * cols];
+            if (p.rule == ContinuousRule::Lenia) {
+                const float *u = &potential[0][(size_t)r * cols];
+                const float k = -1 / (2 * p.sigma * p.sigma);
+                for (int c = 0; c < cols; ++c) {
+                    float d = u[c] - p.mu;
+                    a[c] = std::clamp(a[c] + p.dt * (2 * std::exp(d * d * k) - 1), 0.f, 1.f);
+                }
+            } else {
+                const float *m = &potential[0][(size_t)r * cols], *n = &potential[1][(size_t)r * cols];
+                for (int c = 0; c < cols; ++c) a[c] = smoothLifeTransition(n[c], m[c], p);
+            }
+        });
+        generation++;
+        stepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // Sum of all cell values.
+    double mass() const {
+        double s = 0;
+        for (float v : cells) s += v;
+        return s;
+    }
+
+private:
+    struct CachedSpectrum {
+        std::string shape;
+        float radius;
+        std::vector<cfloat> spec;
+    };
+
+    int rows, cols;
+    RealFft2d fft;
+    std::vector<float> cells;
+    std::vector<cfloat> boardSpec, scratch;
+    std::vector<std::vector<float>> potential;  // one convolution result per kernel
+    std::vector<const std::vector<cfloat> *> kernels;
+    std::vector<std::unique_ptr<CachedSpectrum>> cache;
+    ContinuousParams params;
+    long long generation = 0;
+    double stepMs = 0;
+
+    // The spectrum of shape(distance / radius), centred on cell (0, 0) with
+    // wraparound, scaled so the kernel sums to 1 and the inverse FFT comes
+    // out normalized.
+    template <class Shape>
+    const std::vector<cfloat> &spectrum(const std::string &shape, float radius, Shape fn) {
+        for (auto &c : cache)
+            if (c->shape == shape && c->radius == radius) return c->spec;
+        std::vector<float> k(cells.size(), 0.f);
+        const int reach = (int)std::ceil(radius) + 1;
+        double sum = 0;
+        for (int dy = -reach; dy <= reach; ++dy)
+            for (int dx = -reach; dx <= reach; ++dx) {
+                float v = fn(std::sqrt((float)(dy * dy + dx * dx)) / radius);
+                k[(size_t)((dy % rows + rows) % rows) * cols + (dx % cols + cols) % cols] += v;
+                sum += v;
+            }
+        const float scale = sum > 0 ? (float)(1 / (sum * rows * cols)) : 0.f;
+        for (float &v : k) v *= scale;
+        auto c = std::make_unique<CachedSpectrum>();
+        c->shape = shape;
+        c->radius = radius;
+        c->spec.resize(boardSpec.size());
+        fft.forward(k.data(), c->spec.data());
+        cache.push_back(std::move(c));
+        return cache.back()->spec;
+    }
+
+    static float sigmoid(float x, float a, float alpha) { return 1 / (1 + std::exp(-(x - a) * 4 / alpha)); }
+
+    static float smoothLifeTransition(float n, float m, const ContinuousParams &p) {
+        float alive = sigmoid(m, 0.5f, p.alphaM);
+        float lo = p.b1 * (1 - alive) + p.d1 * alive, hi = p.b2 * (1 - alive) + p.d2 * alive;
+        return sigmoid(n, lo, p.alphaN) * (1 - sigmoid(n, hi, p.alphaN));
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+//
+// ---------- Frame Pacer ----------
+//
+// Holds frames to steady_clock deadlines one period apart. The pacer sleeps
+// until shortly before the deadline, then spins for the rest. The spin
+// margin follows the worst recent oversleep, so it stays small where sleeps
+// are precise and grows where the scheduler is coarse. A frame that finishes
+// more than a period late counts the deadlines it missed as dropped. The
+// schedule then restarts from now instead of bursting to catch up.
+//
+// With rate 0 (e.g. vsync doing the pacing) wait() only measures.
+//
+class FramePacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit FramePacer(double hz = 60, size_t window = 120) : intervals(window, 0) {
+        setRate(hz);
+        last = deadline = clock::now();
+    }
+
+    void setRate(double hz) {
+        period = hz > 0 ? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / hz))
+                        : clock::duration::zero();
+        deadline = clock::now() + period;
+    }
+
+    // Starts a fresh schedule, e.g. after a pause the pacer did not see.
+    void restart() {
+        last = clock::now();
+        deadline = last + period;
+    }
+    bool isPacing() const { return period > clock::duration::zero(); }
+    // True once wait() would no longer sleep, only spin out the last of the
+    // period; a caller can do other work (poll input) until then.
+    bool due() const { return !isPacing() || clock::now() >= deadline - margin; }
+
+    // Blocks until the next frame is due and records the frame interval.
+    void wait() {
+        if (isPacing()) {
+            auto now = clock::now();
+            if (now < deadline - margin) {
+                auto target = deadline - margin;
+                std::this_thread::sleep_until(target);
+                auto over = clock::now() - target;
+                // adopt a larger oversleep at once, let the margin decay slowly
+                margin = std::max(over + kSpinFloor, margin - margin / 16);
+            }
+            while (clock::now() < deadline) std::this_thread::yield();
+
+            now = clock::now();
+            if (now - deadline >= period) {
+                dropped += (now - deadline) / period;
+                deadline = now;
+            }
+            deadline += period;
+        }
+
+        auto now = clock::now();
+        double ms = std::chrono::duration<double, std::milli>(now - last).count();
+        last = now;
+        intervals[next++ % intervals.size()] = ms;
+        lastMs = ms;
+    }
+
+    double lastFrameMs() const { return lastMs; }
+    long long droppedFrames() const { return (long long)dropped; }
+
+    // Mean and standard deviation of the recent frame intervals, in ms.
+    void frameStats(double &mean, double &stddev) const {
+        size_t n = std::min(next, intervals.size());
+        mean = stddev = 0;
+        if (!n) return;
+        for (size_t i = 0; i < n; ++i) mean += intervals[i];
+        mean /= n;
+        for (size_t i = 0; i < n; ++i) stddev += (intervals[i] - mean) * (intervals[i] - mean);
+        stddev = std::sqrt(stddev / n);
+    }
+
+private:
+    static constexpr clock::duration kSpinFloor = std::chrono::microseconds(200);
+
+    clock::duration period{}, margin = std::chrono::milliseconds(2);
+    clock::time_point last, deadline;
+    clock::rep dropped = 0;
+    std::vector<double> intervals;  // ring of recent frame times
+    size_t next = 0;
+    double lastMs = 0;
+};
@@ -0,0 +1,267 @@
+#pragma once
+#include "life_accel.hpp"
+#include "page_memory.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+//
+// ---------- Frame Stream Format ----------
+//
+// Binary, little-endian, meant to be piped:
+//   FrameStreamHeader, then one FrameRecord header plus payload per generation.
+//   'F' frame: rows * wordsPerRow words, the snapshot row layout.
+//   'D' delta: DeltaWord entries; XOR each mask into word `word` of row `row`
+//              of the previous generation to get this one.
+// A delta stream opens with a frame and repeats one every `keyframe`
+// generations, so a consumer can join at any frame record.
+//
+struct FrameStreamHeader {
+    char magic[8];     // "LIFESTRM"
+    uint32_t version;  // kFrameStreamVersion
+    uint32_t keyframe; // 0: every record is a frame
+    uint32_t cols, rows;
+    uint64_t wordsPerRow;
+};
+
+struct FrameRecord {
+    uint32_t kind;     // 'F' or 'D'
+    uint32_t live;     // population, saturated at UINT32_MAX
+    int64_t generation;
+    uint64_t bytes;    // payload size
+};
+
+struct DeltaWord {
+    uint32_t row, word;
+    uint64_t mask;
+};
+
+constexpr char kFrameStreamMagic[8] = {'L', 'I', 'F', 'E', 'S', 'T', 'R', 'M'};
+constexpr uint32_t kFrameStreamVersion = 1;
+
+//
+// ---------- Stream Writer ----------
+//
+// Buffers output in large page-aligned chunks. When the descriptor is a pipe
+// on Linux the chunks are handed over with vmsplice, which maps the pages
+// into the pipe instead of copying them. The pipe may still reference a
+// spliced chunk until the reader gets to it, so chunks form a ring sized
+// well past the pipe capacity, and a chunk is only refilled once more than a
+// full pipe of data has been spliced after it.
+//
+class StreamWriter {
+public:
+    explicit StreamWriter(int fd, size_t chunk = 1 << 20) : fd(fd), chunkSize(chunk) {
+#ifdef __linux__
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode)) {
+            fcntl(fd, F_SETPIPE_SZ, (int)chunkSize);
+            int cap = fcntl(fd, F_GETPIPE_SZ);
+            splice = cap > 0 && (size_t)cap <= chunkSize;
+        }
+#endif
+        for (size_t i = 0; i < (splice ? kRing : 1); ++i) {
+            void *p = pageAlloc(chunkSize);
+            if (!p) throw std::bad_alloc();
+            chunks.push_back((uint8_t *)p);
+        }
+    }
+    StreamWriter(const StreamWriter &) = delete;
+    StreamWriter &operator=(const StreamWriter &) = delete;
+    ~StreamWriter() {
+        flush();
+        for (uint8_t *c : chunks) pageFree(c, chunkSize);
+    }
+
+    bool write(const void *data, size_t n) {
+        const uint8_t *p = (const uint8_t *)data;
+        while (n && ok) {
+            size_t take = std::min(n, chunkSize - used);
+            std::memcpy(chunks[cur] + used, p, take);
+            used += take;
+            p += take;
+            n -= take;
+            if (used == chunkSize) flush();
+        }
+        return ok;
+    }
+
+    bool flush() {
+        if (!used || !ok) return ok;
+        const uint8_t *p = chunks[cur];
+        size_t n = used;
+#ifdef __linux__
+        while (splice && n) {
+            iovec iov{(void *)p, n};
+            ssize_t k = vmsplice(fd, &iov, 1, 0);
+            if (k < 0 && errno == EINTR) continue;
+            if (k < 0) {
+                splice = false;  // e.g. EINVAL on an unsupported pipe; fall back
+                break;
+            }
+            p += k;
+            n -= (size_t)k;
+        }
+#endif
+        while (n) {
+#ifdef _WIN32
+            int k = _write(fd, p, (unsigned)std::min<size_t>(n, 1 << 30));
+#else
+            ssize_t k = ::write(fd, p, n);
+            if (k < 0 && errno == EINTR) continue;
+#endif
+            if (k <= 0) {
+                ok = false;  // reader went away
+                return false;
+            }
+            p += k;
+            n -= (size_t)k;
+        }
+        used = 0;
+        cur = (cur + 1) % chunks.size();
+        return true;
+    }
+
+    bool good() const { return ok; }
+    bool usingSplice() const { return splice; }
+
+private:
+    static constexpr size_t kRing = 4;  // three chunks in flight, each a full pipe
+    int fd;
+    size_t chunkSize, used = 0, cur = 0;
+    std::vector<uint8_t *> chunks;
+    bool splice = false, ok = true;
+};
+
+//
+// ---------- Frame Encoder ----------
+//
+// Packs each generation into snapshot words and writes it as a frame, or as
+// the XOR of the words that changed since the previous generation. Only rows
+// inside the live box of either generation are packed, and only they are
+// read from the board, so cold pages elsewhere stay packed.
+//
+class FrameEncoder {
+public:
+    FrameEncoder(StreamWriter &out, int rows, int cols, uint32_t keyframe)
+        : out(out), rows(rows), cols(cols), keyframe(keyframe),
+          wordsPerRow((cols + 63) / 64), prev((size_t)rows * wordsPerRow, 0) {
+        FrameStreamHeader h;
+        std::memcpy(h.magic, kFrameStreamMagic, 8);
+        h.version = kFrameStreamVersion;
+        h.keyframe = keyframe;
+        h.cols = cols;
+        h.rows = rows;
+        h.wordsPerRow = wordsPerRow;
+        out.write(&h, sizeof h);
+    }
+
+    bool emit(const LifeAccel &life, int64_t gen) {
+        CellBox box = life.getBounds(), touched = box;
+        touched.add(prevBox);
+        prevBox = box;
+        const uint8_t *cells = life.cellsIn(touched);
+        uint32_t live = (uint32_t)std::min<int64_t>(life.getLiveCount(), UINT32_MAX);
+        bool frame = keyframe == 0 || count++ % keyframe == 0;
+
+        std::vector<uint64_t> words(wordsPerRow);
+        delta.clear();
+        for (int r = touched.empty() ? rows : touched.top; r <= touched.bottom; ++r) {
+            std::fill(words.begin(), words.end(), 0);
+            const uint8_t *row = cells + (size_t)r * cols;
+            for (int c = box.left; c <= box.right && r >= box.top && r <= box.bottom; ++c)
+                words[c >> 6] |= (uint64_t)row[c] << (c & 63);
+            uint64_t *old = &prev[(size_t)r * wordsPerRow];
+            for (size_t w = 0; w < wordsPerRow; ++w)
+                if (uint64_t x = words[w] ^ old[w]) {
+                    if (!frame) delta.push_back({(uint32_t)r, (uint32_t)w, x});
+                    old[w] = words[w];
+                }
+        }
+
+        FrameRecord rec{frame ? (uint32_t)'F' : (uint32_t)'D', live, gen,
+                        frame ? prev.size() * 8 : delta.size() * sizeof(DeltaWord)};
+        out.write(&rec, sizeof rec);
+        if (frame) return out.write(prev.data(), prev.size() * 8);
+        return out.write(delta.data(), delta.size() * sizeof(DeltaWord));
+    }
+
+private:
+    StreamWriter &out;
+    int rows, cols;
+    uint32_t keyframe, count = 0;
+    size_t wordsPerRow;
+    std::vector<uint64_t> prev;  // last emitted generation
+    std::vector<DeltaWord> delta;
+    CellBox prevBox;
+};
+
+//
+// ---------- Stream Reader ----------
+//
+// Applies records from a frame stream to a local copy of the board.
+//
+class FrameStreamReader {
+public:
+    explicit FrameStreamReader(FILE *in) : in(in) {}
+
+    bool open(std::string *error = nullptr) {
+        if (fread(&hdr, sizeof hdr, 1, in) != 1 || std::memcmp(hdr.magic, kFrameStreamMagic, 8) != 0) {
+            if (error) *error = "not a frame stream";
+            return false;
+        }
+        if (hdr.version != kFrameStreamVersion) {
+            if (error) *error = "frame stream version " + std::to_string(hdr.version);
+            return false;
+        }
+        words.assign((size_t)hdr.rows * hdr.wordsPerRow, 0);
+        return true;
+    }
+
+    // Reads one record; false at end of stream.
+    bool next() {
+        FrameRecord rec;
+        if (fread(&rec, sizeof rec, 1, in) != 1) return false;
+        if (rec.kind == 'F') {
+            if (rec.bytes != words.size() * 8 || fread(words.data(), 8, words.size(), in) != words.size())
+                return false;
+        } else {
+            delta.resize(rec.bytes / sizeof(DeltaWord));
+            if (fread(delta.data(), sizeof(DeltaWord), delta.size(), in) != delta.size()) return false;
+            for (const DeltaWord &d : delta)
+                if (d.row < hdr.rows && d.word < hdr.wordsPerRow)
+                    words[(size_t)d.row * hdr.wordsPerRow + d.word] ^= d.mask;
+        }
+        generation = rec.generation;
+        live = rec.live;
+        return true;
+    }
+
+    const FrameStreamHeader &header() const { return hdr; }
+    const uint64_t *row(uint32_t r) const { return &words[(size_t)r * hdr.wordsPerRow]; }
+    int64_t getGeneration() const { return generation; }
+    uint32_t getLive() const { return live; }
+
+private:
+    FILE *in;
+    FrameStreamHeader hdr{};
+    std::vector<uint64_t> words;
+    std::vector<DeltaWord> delta;
+    int64_t generation = -1;
+    uint32_t live = 0;
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include "life_accel.hpp"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <climits>
+
+//
+// ---------- Interval Engine ----------
+//
+// Each row is a sorted list of disjoint live runs [begin, end). A new row is
+// built from three linear merges instead of a per-cell scan:
+//   1. the run boundaries of the rows above, at and below give the
+//      piecewise-constant vertical sum V(c) as sorted +1/-1 events;
+//   2. the 3x3 box sum is V(c-1) + V(c) + V(c+1), i.e. the same event list
+//      read at three offsets, merged with the centre row's own runs;
+//   3. sweeping that merge emits runs where the box sum is 3, or 4 on a
+//      live cell (the box includes the cell itself).
+// The cost follows the number of runs, not the row width.
+//
+struct Run {
+    int begin, end;
+};
+
+class IntervalLife {
+public:
+    IntervalLife(int rows, int cols, ThreadPool &p)
+        : rows(rows), cols(cols), cur(rows), nxt(rows), pool(p) {}
+
+    static IntervalLife fromDense(const LifeAccel &life, ThreadPool &p) {
+        IntervalLife il(life.getRows(), life.getCols(), p);
+        const uint8_t *cells = life.cells();
+        for (int i = 0; i < il.rows; ++i) {
+            const uint8_t *r = cells + (size_t)i * il.cols;
+            for (int j = 0; j < il.cols;) {
+                if (!r[j]) { ++j; continue; }
+                int b = j;
+                while (j < il.cols && r[j]) ++j;
+                il.cur[i].push_back({b, j});
+            }
+        }
+        return il;
+    }
+
+    // Overwrites a LifeAccel of the same size with this board.
+    void toDense(LifeAccel &life) const {
+        uint8_t *cells = life.cells();
+        std::fill(cells, cells + (size_t)rows * cols, 0);
+        for (int i = 0; i < rows; ++i)
+            for (const Run &r : cur[i])
+                std::fill(cells + (size_t)i * cols + r.begin, cells + (size_t)i * cols + r.end, 1);
+    }
+
+    void set(int r, int c, bool v) {
+        auto &row = cur[r];
+        auto it = std::lower_bound(row.begin(), row.end(), c, [](const Run &x, int col) { return x.end <= col; });
+        bool inside = it != row.end() && it->begin <= c;
+        if (v == inside) return;
+        if (!v) {
+            // split [b, e) into [b, c) and [c+1, e)
+            Run tail{c + 1, it->end};
+            it->end = c;
+            if (tail.begin < tail.end) it = row.insert(it + 1, tail) - 1;
+            if (it->begin == it->end) row.erase(it);
+            return;
+        }
+        it = row.insert(it, {c, c + 1});
+        if (it + 1 != row.end() && (it + 1)->begin == c + 1) {
+            it->end = (it + 1)->end;
+            row.erase(it + 1);
+        }
+        if (it != row.begin() && (it - 1)->end == c) {
+            (it - 1)->end = it->end;
+            row.erase(it);
+        }
+    }
+
+    void step() {
+        size_t nThreads = std::max<size_t>(1, pool.size());
+        int band = (rows + (int)nThreads - 1) / (int)nThreads;
+        for (int r0 = 0; r0 < rows; r0 += band) {
+            int r1 = std::min(rows, r0 + band);
+            pool.enqueue([=, this]() {
+                for (int i = r0; i < r1; ++i) stepRow(i);
+            });
+        }
+        pool.waitAll();
+        cur.swap(nxt);
+    }
+
+    long long getLiveCount() const {
+        long long n = 0;
+        for (auto &row : cur)
+            for (const Run &r : row) n += r.end - r.begin;
+        return n;
+    }
+    size_t runCount() const {
+        size_t n = 0;
+        for (auto &row : cur) n += row.size();
+        return n;
+    }
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    const std::vector<Run> &row(int r) const { return cur[r]; }
+
+private:
+    int rows, cols;
+    std::vector<std::vector<Run>> cur, nxt;
+    ThreadPool &pool;
+
+    struct Event {
+        int x, delta;
+        bool operator<(const Event &o) const { return x < o.x; }
+    };
+
+    static void appendEvents(const std::vector<Run> &runs, std::vector<Event> &out) {
+        for (const Run &r : runs) {
+            out.push_back({r.begin, 1});
+            out.push_back({r.end, -1});
+        }
+    }
+
+    void stepRow(int i) {
+        static thread_local std::vector<Event> a, b, vert, self;
+        std::vector<Run> &out = nxt[i];
+        out.clear();
+
+        a.clear(); b.clear(); vert.clear(); self.clear();
+        if (i > 0) appendEvents(cur[i - 1], a);
+        appendEvents(cur[i], b);
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(vert));
+        a.clear();
+        if (i + 1 < rows) appendEvents(cur[i + 1], a);
+        b.swap(vert);
+        vert.clear();
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(vert));
+        if (vert.empty()) return;
+        appendEvents(cur[i], self);
+
+        // heads 0..2 read `vert` shifted by -1, 0, +1; head 3 reads `self`
+        const std::vector<Event> *src[4] = {&vert, &vert, &vert, &self};
+        const int shift[4] = {-1, 0, 1, 0};
+        size_t pos[4] = {0, 0, 0, 0};
+        auto head = [&](int h) {
+            return pos[h] < src[h]->size() ? (*src[h])[pos[h]].x + shift[h] : INT_MAX;
+        };
+
+        int sum = 0, alive = 0;
+        int x = std::min({head(0), head(1), head(2), head(3)});
+        while (x != INT_MAX) {
+            for (int h = 0; h < 4; ++h)
+                while (head(h) == x) {
+                    (h == 3 ? alive : sum) += (*src[h])[pos[h]].delta;
+                    ++pos[h];
+                }
+            int nx = std::min({head(0), head(1), head(2), head(3)});
+            if (nx == INT_MAX) break;
+            if (sum == 3 || (alive && sum == 4)) {
+                int b0 = std::max(x, 0), e0 = std::min(nx, cols);
+                if (b0 < e0) {
+                    if (!out.empty() && out.back().end == b0) out.back().end = e0;
+                    else out.push_back({b0, e0});
+                }
+            }
+            x = nx;
+        }
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include "life_kernel.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+//
+// ---------- Kernel Library ----------
+//
+// Owns a dlopen'ed kernel plugin. The table it hands out stays valid for the
+// lifetime of this object, so boards using the kernel hold a shared_ptr.
+//
+class KernelLibrary {
+public:
+    KernelLibrary(const KernelLibrary &) = delete;
+    KernelLibrary &operator=(const KernelLibrary &) = delete;
+    ~KernelLibrary() {
+#ifdef _WIN32
+        if (handle) FreeLibrary((HMODULE)handle);
+#else
+        if (handle) dlclose(handle);
+#endif
+    }
+
+    static std::shared_ptr<KernelLibrary> open(const std::string &path, std::string *error) {
+        std::shared_ptr<KernelLibrary> lib(new KernelLibrary);
+        auto fail = [&](const std::string &msg) {
+            if (error) *error = path + ": " + msg;
+            return nullptr;
+        };
+#ifdef _WIN32
+        lib->handle = (void *)LoadLibraryA(path.c_str());
+        if (!lib->handle) return fail("cannot load library");
+        auto entry = (life_kernel_entry_fn)(void *)GetProcAddress((HMODULE)lib->handle, LIFE_KERNEL_ENTRY);
+#else
+        lib->handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!lib->handle) {
+            if (error) *error = dlerror();  // already names the file
+            return nullptr;
+        }
+        auto entry = (life_kernel_entry_fn)dlsym(lib->handle, LIFE_KERNEL_ENTRY);
+#endif
+        if (!entry) return fail("missing " LIFE_KERNEL_ENTRY);
+        lib->table = entry();
+        if (!lib->table || !lib->table->step_band) return fail("empty kernel table");
+        if (lib->table->abi_version != LIFE_KERNEL_ABI_VERSION)
+            return fail("kernel ABI " + std::to_string(lib->table->abi_version) +
+                        ", expected " + std::to_string(LIFE_KERNEL_ABI_VERSION));
+        return lib;
+    }
+
+    const life_kernel &kernel() const { return *table; }
+
+private:
+    KernelLibrary() = default;
+    void *handle = nullptr;
+    const life_kernel *table = nullptr;
+};
+
+//
+// ---------- Golden Corpus ----------
+//
+// Boards a kernel must reproduce exactly against the built-in kernel before
+// it may be selected. Patterns sit against every edge and corner, where
+// out-of-bounds handling usually goes wrong, and seeded soups cover the rest.
+//
+struct CorpusCase {
+    std::string name;
+    int rows, cols, gens;
+    double fill;    // > 0: seeded random soup
+    uint32_t seed;
+    std::vector<std::pair<int, int>> cells;
+};
+
+inline std::vector<CorpusCase> goldenCorpus() {
+    const std::vector<std::pair<int, int>> glider = {{0, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}};
+    const std::vector<std::pair<int, int>> rpent = {{0, 1}, {0, 2}, {1, 0}, {1, 1}, {2, 1}};
+    auto at = [](std::vector<std::pair<int, int>> p, int r, int c) {
+        for (auto &x : p) { x.first += r; x.second += c; }
+        return p;
+    };
+
+    std::vector<CorpusCase> corpus = {
+        {"blinker-corner", 8, 8, 3, 0, 0, {{0, 0}, {0, 1}, {0, 2}}},
+        {"glider-into-corner", 16, 16, 60, 0, 0, at(glider, 8, 8)},
+        {"glider-left-edge", 16, 16, 8, 0, 0, at(glider, 6, 0)},
+        {"rpent-bottom-right", 24, 24, 40, 0, 0, at(rpent, 21, 21)},
+        {"rpent-centre", 96, 96, 200, 0, 0, at(rpent, 48, 48)},
+        {"single-row", 1, 70, 4, 0, 0, {{0, 10}, {0, 11}, {0, 12}}},
+        {"single-col", 70, 1, 4, 0, 0, {{10, 0}, {11, 0}, {12, 0}}},
+    };
+    const int sizes[][2] = {{37, 53}, {64, 64}, {65, 130}, {200, 7}};
+    uint32_t seed = 1;
+    for (auto &s : sizes)
+        corpus.push_back({"soup-" + std::to_string(s[0]) + "x" + std::to_string(s[1]),
+                          s[0], s[1], 30, 0.35, seed++, {}});
+    return corpus;
+}
+
+struct KernelReport {
+    std::string name, error;
+    bool valid = false, selected = false;
+    double baselineMs = 0, pluginMs = 0;  // per generation
+};
@@ -0,0 +1,74 @@
+#include "../life_kernel.h"
+#include <algorithm>
+
+//
+// ---------- Example Kernel Plugin ----------
+//
+// Reference plugin for the kernel ABI: B3/S23 with the bounds checks hoisted
+// out of the inner loop. Interior columns read the three source rows
+// directly; only the first and last column of the board take the slow path.
+//
+namespace {
+
+inline int at(const uint8_t *cur, int32_t rows, int32_t cols, int32_t r, int32_t c) {
+    return (r >= 0 && r < rows && c >= 0 && c < cols) ? cur[(size_t)r * cols + c] : 0;
+}
+
+void stepBand(void *, const uint8_t *cur, uint8_t *next, int32_t rows, int32_t cols,
+              int32_t row0, int32_t row1, int32_t col0, int32_t col1) {
+    for (int32_t i = row0; i < row1; ++i) {
+        const uint8_t *up = i > 0 ? cur + (size_t)(i - 1) * cols : nullptr;
+        const uint8_t *mid = cur + (size_t)i * cols;
+        const uint8_t *dn = i + 1 < rows ? cur + (size_t)(i + 1) * cols : nullptr;
+        uint8_t *out = next + (size_t)i * cols;
+
+        int32_t lo = std::max(col0, 1), hi = std::min(col1, cols - 1);
+        for (int32_t j = col0; j < std::min(col1, lo); ++j) {
+            int n = 0;
+            for (int dr = -1; dr <= 1; ++dr)
+                for (int dc = -1; dc <= 1; ++dc)
+                    if (dr || dc) n += at(cur, rows, cols, i + dr, j + dc);
+            out[j] = mid[j] ? (n == 2 || n == 3) : (n == 3);
+        }
+        if (!up || !dn) {
+            // top or bottom row: missing neighbour row reads as zeros
+            for (int32_t j = lo; j < hi; ++j) {
+                int n = mid[j - 1] + mid[j + 1];
+                if (up) n += up[j - 1] + up[j] + up[j + 1];
+                if (dn) n += dn[j - 1] + dn[j] + dn[j + 1];
+                out[j] = mid[j] ? (n == 2 || n == 3) : (n == 3);
+            }
+        } else {
+            for (int32_t j = lo; j < hi; ++j) {
+                int n = up[j - 1] + up[j] + up[j + 1] + mid[j - 1] + mid[j + 1] +
+                        dn[j - 1] + dn[j] + dn[j + 1];
+                out[j] = (uint8_t)((n == 3) | (mid[j] & (n == 2)));
+            }
+        }
+        for (int32_t j = std::max(hi, lo); j < col1; ++j) {
+            int n = 0;
+            for (int dr = -1; dr <= 1; ++dr)
+                for (int dc = -1; dc <= 1; ++dc)
+                    if (dr || dc) n += at(cur, rows, cols, i + dr, j + dc);
+            out[j] = mid[j] ? (n == 2 || n == 3) : (n == 3);
+        }
+    }
+}
+
+const life_kernel kTable = {
+    LIFE_KERNEL_ABI_VERSION,
+    "example-hoisted",
+    LIFE_KERNEL_CAP_REENTRANT | LIFE_KERNEL_CAP_SUBRECT,
+    nullptr,
+    nullptr,
+    stepBand,
+};
+
+} // namespace
+
+#if defined(_WIN32)
+extern "C" __declspec(dllexport)
+#else
+extern "C" __attribute__((visibility("default")))
+#endif
+const life_kernel *life_kernel_entry(void) { return &kTable; }
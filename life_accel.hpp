@@ -0,0 +1,1181 @@
+#pragma once
+#include "snapshot.hpp"
+#include "kernel_plugin.hpp"
+#include "page_memory.hpp"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <queue>
+#include <functional>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include <deque>
+#include <numeric>
+#include <cmath>
+#include <fstream>
+#include <memory>
+
+namespace sf {
+class VertexArray;
+class Color;
+}
+
+//
+// ---------- Thread Pool ----------
+//
+class ThreadPool {
+public:
+    ThreadPool(size_t n = std::thread::hardware_concurrency()) : stop(false) {
+        for (size_t i = 0; i < n; ++i)
+            workers.emplace_back([this, i]() { workerId() = (int)i; workerLoop(); });
+    }
+    ~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(qMutex);
+            stop = true;
+        }
+        cond.notify_all();
+        for (auto &t : workers) t.join();
+    }
+    void enqueue(std::function<void()> job) {
+        {
+            std::unique_lock<std::mutex> lock(qMutex);
+            tasks.push(std::move(job));
+        }
+        cond.notify_one();
+    }
+    void waitAll() {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCond.wait(lock, [this]() { return tasks.empty() && activeWorkers == 0; });
+    }
+    size_t size() const { return workers.size(); }
+
+    // Index of the pool worker running the caller, or -1 off-pool.
+    static int currentWorker() { return workerId(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex qMutex, doneMutex;
+    std::condition_variable cond, doneCond;
+    std::atomic<int> activeWorkers{0};
+    bool stop;
+
+    static int &workerId() {
+        static thread_local int id = -1;
+        return id;
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(qMutex);
+                cond.wait(lock, [this]() { return stop || !tasks.empty(); });
+                if (stop && tasks.empty()) return;
+                job = std::move(tasks.front());
+                tasks.pop();
+                ++activeWorkers;
+            }
+            job();
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                --activeWorkers;
+                if (tasks.empty() && activeWorkers == 0)
+                    doneCond.notify_all();
+            }
+        }
+    }
+};
+
+//
+// ---------- LifeAccel ----------
+//
+// Built-in B3/S23 kernels for the byte-per-cell grid.
+enum class BuiltinKernel {
+    Gather,  // 8 bounds-checked loads per cell
+    RowSum,  // vertical 3-row sums, then a sliding 3-wide window
+};
+
+// The RowSum kernel on rows [i0, i1) and columns [j0, j1) of a row-major
+// byte grid; cells outside the grid are dead, and `zero` (cols zero bytes)
+// stands in for the rows above and below it. Returns whether any written
+// cell changed. Engines with their own grids (mpi_engine.hpp) step their
+// blocks with it too.
+//
+// Separable count: sum[k] holds the 3-row column sum of column j0-1+k,
+// so each cell reads three sums and itself instead of eight neighbours.
+// Both inner loops are branch-free and auto-vectorize.
+inline bool stepBandRowSum(const uint8_t *cur, uint8_t *next, int rows, int cols,
+                           int i0, int i1, int j0, int j1, const uint8_t *zero) {
+    static thread_local std::vector<uint8_t> sum;
+    const int w = j1 - j0;
+    sum.resize(w + 2);
+    uint8_t diff = 0;
+    for (int i = i0; i < i1; ++i) {
+        const uint8_t *mid = &cur[(size_t)i * cols];
+        const uint8_t *up = i > 0 ? mid - cols : zero;
+        const uint8_t *dn = i + 1 < rows ? mid + cols : zero;
+        uint8_t *out = &next[(size_t)i * cols];
+
+        sum[0] = j0 > 0 ? up[j0 - 1] + mid[j0 - 1] + dn[j0 - 1] : 0;
+        sum[w + 1] = j1 < cols ? up[j1] + mid[j1] + dn[j1] : 0;
+        for (int k = 0; k < w; ++k)
+            sum[k + 1] = up[j0 + k] + mid[j0 + k] + dn[j0 + k];
+
+        uint8_t d = 0;
+        for (int k = 0; k < w; ++k) {
+            uint8_t self = mid[j0 + k];
+            uint8_t n = sum[k] + sum[k + 1] + sum[k + 2] - self;
+            uint8_t v = (n == 3) | (self & (n == 2));
+            d |= out[j0 + k] ^ v;
+            out[j0 + k] = v;
+        }
+        diff |= d;
+    }
+    return diff;
+}
+
+struct TileStat {
+    float ms = 0;     // compute time of the tile in the last generation
+    int worker = -1;  // pool worker that ran it
+};
+
+// Inclusive cell rectangle; empty when bottom < top.
+struct CellBox {
+    int top = 0, left = 0, bottom = -1, right = -1;
+
+    bool empty() const { return bottom < top || right < left; }
+    void add(const CellBox &o) {
+        if (o.empty()) return;
+        if (empty()) { *this = o; return; }
+        top = std::min(top, o.top); left = std::min(left, o.left);
+        bottom = std::max(bottom, o.bottom); right = std::max(right, o.right);
+    }
+    CellBox grown(int n, int rows, int cols) const {
+        if (empty()) return *this;
+        return {std::max(0, top - n), std::max(0, left - n),
+                std::min(rows - 1, bottom + n), std::min(cols - 1, right + n)};
+    }
+    CellBox clipped(const CellBox &o) const {
+        CellBox c{std::max(top, o.top), std::max(left, o.left),
+                  std::min(bottom, o.bottom), std::min(right, o.right)};
+        return c.empty() ? CellBox{} : c;
+    }
+};
+
+class LifeAccel {
+public:
+    LifeAccel(int w, int h, int c, ThreadPool &p)
+        : width(w), height(h), cellSize(c),
+          cols(w / c), rows(h / c),
+          current((size_t)rows * cols),
+          next((size_t)rows * cols),
+          zeroRow(cols, 0),
+          pool(p) {
+        setTileSize(32);
+        if (current.size() >= kPageAllocThreshold) {
+            block[0] = current.data();
+            block[1] = next.data();
+            pageState.assign((current.size() + pageSize() - 1) / pageSize(), kPageWarm);
+        }
+    }
+    LifeAccel(const LifeAccel &) = delete;
+    LifeAccel &operator=(const LifeAccel &) = delete;
+    ~LifeAccel() {
+        if (coldThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lk(coldMutex);
+                coldStop = true;
+            }
+            coldCv.notify_all();
+            coldThread.join();
+        }
+        useKernel(nullptr);
+    }
+
+    // Tiles are the unit of work handed to the pool.
+    void setTileSize(int t) {
+        tileSize = std::max(4, t);
+        tileRows = (rows + tileSize - 1) / tileSize;
+        tileCols = (cols + tileSize - 1) / tileSize;
+        tileStats.assign(tileRows * tileCols, TileStat{});
+        changedPrev.assign(tileRows * tileCols, 1);
+        changedNow.assign(tileRows * tileCols, 1);
+        quietGens.assign(tileRows * tileCols, 0);
+        for (auto &b : tileBounds) b.assign(tileRows * tileCols, TileBounds{});
+        for (auto &p : rowPrefix) p = Counts((size_t)tileCols * rows);
+        for (auto &p : colPrefix) p = Counts((size_t)tileRows * cols);
+        popLevels.clear();
+        for (int r = tileRows, c = tileCols;; r = (r + 1) / 2, c = (c + 1) / 2) {
+            popLevels.push_back({r, c, std::vector<long long>((size_t)r * c, 0)});
+            if (r == 1 && c == 1) break;
+        }
+        popValid = false;
+        historyValid = false;
+    }
+    int getTileSize() const { return tileSize; }
+    int getTileCount() const { return tileRows * tileCols; }
+    int getSleepingTiles() const { return sleepingTiles; }
+
+    // On page-allocated boards, a page whose tiles and their neighbours have
+    // all gone `gens` generations without changing is packed by a background
+    // thread and handed back to the OS; stepping or writing there unpacks it,
+    // reading there only until the next step. 0 turns this off.
+    void setColdCompression(int gens) {
+        coldAfter = std::clamp(gens, 0, 65535);
+        if (!coldAfter) thawAll(true);
+    }
+    size_t getColdPages() const { return coldPages.size(); }
+    size_t getColdBytes() const { return coldBytes; }  // packed size of the cold pages
+
+    void randomize(double fill = 0.25) {
+        std::mt19937 rng(std::random_device{}());
+        randomize(fill, rng);
+    }
+    void randomize(double fill, std::mt19937 &rng) {
+        std::uniform_real_distribution<double> dist(0, 1);
+        thawAll(true);
+        for (auto &c : current)
+            c = dist(rng) < fill ? 1 : 0;
+        invalidateHistory();
+    }
+
+    // Must follow any edit of the current generation from outside step():
+    // sleeping tiles trust that the back buffer holds generation t-1, and
+    // the live bounds of both buffers are only known from stepping.
+    void invalidateHistory() {
+        historyValid = false;
+        boundsKnown = 0;
+        popValid = false;
+    }
+
+    // Tiles sleep QuickLife-style: the back buffer still holds generation
+    // t-1 when t+1 is written into it, so a tile whose whole neighbourhood
+    // came out equal to two generations back (still life or period 2) needs
+    // no work at all -- its t-1 cells already are its t+1 cells.
+    //
+    // Stepping is also confined to the live bounding box: births and
+    // survivors lie within one cell of today's box, and the back buffer is
+    // live only inside its own box, so outside the union of the two both
+    // buffers are dead and nothing needs writing. Per-tile population and
+    // bounds measured after each step keep the box exact as patterns shrink.
+    void updateParallel() {
+        using clk = std::chrono::steady_clock;
+        auto wall0 = clk::now();
+        bool trusted = historyValid;
+        if (!trusted) std::fill(changedPrev.begin(), changedPrev.end(), 1);
+        sleepingTiles = 0;
+
+        CellBox active{0, 0, rows - 1, cols - 1};
+        if (boundsKnown == 2) {
+            active = liveBox.grown(1, rows, cols);
+            active.add(backBox);
+        }
+        std::vector<TileBounds> &bounds = tileBounds[backIdx];
+
+        uint32_t caps = kernel ? kernel->capabilities : LIFE_KERNEL_CAP_REENTRANT | LIFE_KERNEL_CAP_SUBRECT;
+        // a kernel without SUBRECT is only ever given full-width column
+        // ranges, so for it the box confines rows alone
+        auto confine = [&](const CellBox &r) {
+            CellBox c = r.clipped(active);
+            if (!(caps & LIFE_KERNEL_CAP_SUBRECT) && !c.empty()) {
+                c.left = 0;
+                c.right = cols - 1;
+            }
+            return c;
+        };
+        if (!(caps & LIFE_KERNEL_CAP_REENTRANT)) {
+            // plugin must see the whole board from one thread
+            std::fill(tileStats.begin(), tileStats.end(), TileStat{});
+            CellBox r = confine({0, 0, rows - 1, cols - 1});
+            if (!r.empty()) {
+                thawRect(r.grown(1, rows, cols), true);
+                stepRect(r.top, r.bottom + 1, r.left, r.right + 1);
+            }
+            std::fill(changedNow.begin(), changedNow.end(), 1);
+            for (int t = 0; t < tileRows * tileCols; ++t)
+                bounds[t] = measureTile(t, r);
+        } else {
+            // without SUBRECT a job covers a full row of tiles
+            int bandCols = (caps & LIFE_KERNEL_CAP_SUBRECT) ? 1 : tileCols;
+            for (int ty = 0; ty < tileRows; ++ty)
+                for (int tx = 0; tx < tileCols; tx += bandCols) {
+                    CellBox r = confine(tileRect(ty, tx, bandCols));
+                    bool idle = r.empty();
+                    if (idle || asleep(ty, tx, bandCols)) {
+                        for (int k = 0; k < bandCols; ++k) {
+                            tileStats[ty * tileCols + tx + k] = TileStat{};
+                            changedNow[ty * tileCols + tx + k] = 0;
+                            if (idle) bounds[ty * tileCols + tx + k] = TileBounds{};
+                        }
+                        if (!idle) sleepingTiles += bandCols;
+                        continue;
+                    }
+                    thawRect(r.grown(1, rows, cols), true);
+                    pool.enqueue([=, this, &bounds]() {
+                        auto t0 = clk::now();
+                        bool changed = stepRect(r.top, r.bottom + 1, r.left, r.right + 1);
+                        for (int k = 0; k < bandCols; ++k)
+                            bounds[ty * tileCols + tx + k] = measureTile(ty * tileCols + tx + k, r);
+                        float ms = std::chrono::duration<float, std::milli>(clk::now() - t0).count();
+                        for (int k = 0; k < bandCols; ++k) {
+                            TileStat &st = tileStats[ty * tileCols + tx + k];
+                            st.ms = ms / bandCols;
+                            st.worker = ThreadPool::currentWorker();
+                            changedNow[ty * tileCols + tx + k] = changed || !trusted;
+                        }
+                    });
+                }
+            pool.waitAll();
+        }
+        refreezeShared();
+        current.swap(next);
+        changedPrev.swap(changedNow);
+        historyValid = true;
+        if (!pageState.empty())
+            for (size_t t = 0; t < quietGens.size(); ++t)
+                quietGens[t] = changedPrev[t] ? 0 : (uint16_t)std::min(65535, quietGens[t] + 1);
+
+        backBox = liveBox;
+        liveBox = CellBox{};
+        liveCount = 0;
+        for (auto &b : bounds) {
+            liveBox.add(b.box);
+            liveCount += b.live;
+        }
+        updatePopulationIndex(bounds, active);
+        backIdx ^= 1;
+        boundsKnown = std::min(2, boundsKnown + 1);
+        if (++sinceRelease >= kReleaseInterval) {
+            sinceRelease = 0;
+            releasePages();
+        }
+        stepMs = std::chrono::duration<double, std::milli>(clk::now() - wall0).count();
+    }
+
+    // Switches stepping to a plugin kernel, or back to the built-in one.
+    void useKernel(std::shared_ptr<KernelLibrary> lib) {
+        if (kernel && kernel->shutdown) kernel->shutdown(kernelState);
+        kernelLib = std::move(lib);
+        kernel = kernelLib ? &kernelLib->kernel() : nullptr;
+        kernelState = kernel && kernel->init ? kernel->init(rows, cols) : nullptr;
+    }
+    void setBuiltinKernel(BuiltinKernel k) { builtin = k; }
+    BuiltinKernel getBuiltinKernel() const { return builtin; }
+    std::string kernelName() const {
+        if (kernel) return kernel->name;
+        return builtin == BuiltinKernel::RowSum ? "builtin-rowsum" : "builtin-gather";
+    }
+
+    // Loads a plugin, checks it against the golden corpus, times it against
+    // the kernel currently in use and switches to it only if it is faster.
+    KernelReport loadKernelPlugin(const std::string &path, int benchGens = 50) {
+        KernelReport rep;
+        auto lib = KernelLibrary::open(path, &rep.error);
+        if (!lib) return rep;
+        rep.name = lib->kernel().name ? lib->kernel().name : path;
+
+        for (const CorpusCase &cc : goldenCorpus()) {
+            LifeAccel ref(cc.cols, cc.rows, 1, pool), cand(cc.cols, cc.rows, 1, pool);
+            cand.useKernel(lib);
+            std::mt19937 rng(cc.seed);
+            if (cc.fill > 0) ref.randomize(cc.fill, rng);
+            for (auto &c : cc.cells) ref.set(c.first, c.second, true);
+            cand.current = ref.current;
+            cand.invalidateHistory();
+            for (int g = 0; g < cc.gens; ++g) {
+                ref.updateParallel();
+                cand.updateParallel();
+                if (ref.current != cand.current) {
+                    rep.error = rep.name + ": mismatch on " + cc.name + " at generation " + std::to_string(g + 1);
+                    return rep;
+                }
+            }
+        }
+        rep.valid = true;
+
+        auto bench = [&](std::shared_ptr<KernelLibrary> k) {
+            LifeAccel b(cols, rows, 1, pool);
+            b.useKernel(std::move(k));
+            b.setTileSize(tileSize);
+            std::mt19937 rng(42);
+            b.randomize(0.3, rng);
+            b.updateParallel();  // warm-up
+            auto t0 = std::chrono::steady_clock::now();
+            for (int g = 0; g < benchGens; ++g) b.updateParallel();
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / benchGens;
+        };
+        rep.baselineMs = bench(kernelLib);
+        rep.pluginMs = bench(lib);
+        if (rep.pluginMs < rep.baselineMs) {
+            useKernel(lib);
+            rep.selected = true;
+        }
+        return rep;
+    }
+
+    // Busy fraction of each pool worker over the last step's wall time.
+    std::vector<double> workerUtilization() const {
+        std::vector<double> busy(pool.size(), 0.0);
+        for (auto &st : tileStats)
+            if (st.worker >= 0 && st.worker < (int)busy.size())
+                busy[st.worker] += st.ms;
+        for (auto &b : busy)
+            b = stepMs > 0 ? std::min(1.0, b / stepMs) : 0.0;
+        return busy;
+    }
+
+    // Rendering lives with the SFML front end (main.cpp), so this header
+    // stays usable from the C API and headless tools. The overlay only
+    // appends quads to `va`; the GL work happens later, on whichever thread
+    // draws it. Cell quads are built there from a copyCells() copy.
+    void appendLoadOverlay(sf::VertexArray &va) const;
+    static sf::Color workerColor(int w);
+
+    // Copies the cells of r (row-major, r's width) into `out`, so a reader
+    // can let go of the board before working through them. Cold pages are
+    // read packed rather than unpacked.
+    void copyCells(const CellBox &r, std::vector<uint8_t> &out) const {
+        const int w = r.empty() ? 0 : r.right - r.left + 1;
+        out.resize(r.empty() ? 0 : (size_t)(r.bottom - r.top + 1) * w);
+        for (int i = r.top; i <= r.bottom && w; ++i) {
+            uint8_t *o = &out[(size_t)(i - r.top) * w];
+            if (!coldPending) {
+                std::copy_n(&current[(size_t)i * cols + r.left], w, o);
+                continue;
+            }
+            for (int j = 0; j < w; ++j) o[j] = alive(i, r.left + j);
+        }
+    }
+
+    int getLiveCount() const {
+        if (boundsKnown) return (int)liveCount;
+        thawAll();
+        int c = 0;
+        for (auto v : current)
+            c += v;
+        return c;
+    }
+
+    // Bounding box of the live cells of the current generation.
+    CellBox getBounds() const {
+        if (boundsKnown) return liveBox;
+        thawAll();
+        CellBox box;
+        for (int i = 0; i < rows; ++i) {
+            const uint8_t *r = &current[(size_t)i * cols];
+            const uint8_t *first = std::find(r, r + cols, 1);
+            if (first == r + cols) continue;
+            int last = cols - 1;
+            while (!r[last]) --last;
+            box.add({i, (int)(first - r), i, last});
+        }
+        return box;
+    }
+    double getStepMs() const { return stepMs; }
+
+    // Live cells inside r, clipped to the board. Whole tiles and blocks of
+    // tiles come from the population pyramid, and tiles cut by one edge of r
+    // from their row or column prefix counts, so only the (at most four)
+    // tiles at its corners are counted cell by cell: a query costs about
+    // perimeter / tileSize + 4 * tileSize^2. Until a step has measured every
+    // tile after an edit, the rect is counted cell by cell.
+    long long populationIn(CellBox r) const {
+        r = r.clipped({0, 0, rows - 1, cols - 1});
+        if (r.empty()) return 0;
+        if (!popValid) return countCells(r);
+        return populationNode((int)popLevels.size() - 1, 0, 0, r);
+    }
+
+    // Live density of `region` resampled to w x h pixels (row-major, 0 for
+    // dead, 64..255 rising with density). Once a pixel spans a quarter tile
+    // or more it reads the one pyramid node under its centre whose size is
+    // nearest its own, so the cost follows the pixel count, not the board or
+    // region size. Closer in, pixels count their (at most 1/16 tile) cells.
+    void renderDensity(const CellBox &region, int w, int h, std::vector<uint8_t> &out) const {
+        out.assign((size_t)w * h, 0);
+        if (region.empty() || w <= 0 || h <= 0) return;
+        const double sy = (region.bottom - region.top + 1) / (double)h;
+        const double sx = (region.right - region.left + 1) / (double)w;
+        const double cpp = std::max(sx, sy);
+        int k = -1;
+        if (cpp >= tileSize / 4.0)
+            k = std::min((int)popLevels.size() - 1, std::max(0, (int)std::log2(cpp / tileSize)));
+        if (k < 0 || !popValid) thawRect(region.clipped({0, 0, rows - 1, cols - 1}));
+        auto shade = [](long long live, long long area) {
+            return live ? (uint8_t)(64 + 191 * std::min<long long>(live, area) / area) : (uint8_t)0;
+        };
+
+        for (int py = 0; py < h; ++py)
+            for (int px = 0; px < w; ++px) {
+                double y0 = region.top + py * sy, x0 = region.left + px * sx;
+                int cy = (int)std::floor(y0 + sy / 2), cx = (int)std::floor(x0 + sx / 2);
+                if (cy < 0 || cy >= rows || cx < 0 || cx >= cols) continue;
+                uint8_t &o = out[(size_t)py * w + px];
+                if (k >= 0 && popValid) {
+                    const PopLevel &lv = popLevels[k];
+                    int span = tileSize << k, ny = cy / span, nx = cx / span;
+                    long long area = (long long)(std::min(rows, (ny + 1) * span) - ny * span) *
+                                     (std::min(cols, (nx + 1) * span) - nx * span);
+                    o = shade(lv.live[(size_t)ny * lv.cols + nx], area);
+                } else if (cpp <= 1 || k >= 0) {
+                    o = current[(size_t)cy * cols + cx] ? 255 : 0;  // pyramid stale: nearest cell
+                } else {
+                    int t = (int)y0, l = (int)x0;
+                    CellBox b = CellBox{t, l, std::max(t, (int)(y0 + sy) - 1), std::max(l, (int)(x0 + sx) - 1)}
+                                    .clipped({0, 0, rows - 1, cols - 1});
+                    if (!b.empty())
+                        o = shade(countCells(b), (long long)(b.bottom - b.top + 1) * (b.right - b.left + 1));
+                }
+            }
+    }
+
+    // Both generation buffers: mapped size and what is actually resident.
+    size_t getGridBytes() const { return 2 * current.size(); }
+    size_t getResidentGridBytes() const {
+        if (current.size() < kPageAllocThreshold) return getGridBytes();
+        return pageResident(current.data(), current.size()) + pageResident(next.data(), next.size());
+    }
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getCellSize() const { return cellSize; }
+    // A cold cell is read from its packed page, so scanning the live box
+    // (the period detector, drawing) does not unpack it.
+    bool alive(int r, int c) const {
+        size_t k = (size_t)r * cols + c;
+        if (coldPending && pageState[k / pageSize()] == kPageFrozen) {
+            const ColdPage &cp = coldPages.at(k / pageSize());
+            return cellInPage(cp.packed[currentBlock()].data(), pageSize(), k % pageSize());
+        }
+        return current[k] != 0;
+    }
+    void set(int r, int c, bool v) {
+        thawRect({r, c, r, c}, true);
+        current[(size_t)r * cols + c] = v;
+        invalidateHistory();
+    }
+
+    // Row-major byte-per-cell view of the current generation. The pointer
+    // alternates between two buffers, so re-fetch it after every step.
+    uint8_t *cells() {
+        thawAll(true);
+        invalidateHistory();
+        return current.data();
+    }
+    const uint8_t *cells() const {
+        thawAll();
+        return current.data();
+    }
+    // As cells(), but only the cells inside r are sure to be unpacked, which
+    // is all a reader confined to the live box needs. Cold pages a reader
+    // unpacks stay cold and are dropped again at the next step.
+    const uint8_t *cellsIn(const CellBox &r) const {
+        thawRect(r.clipped({0, 0, rows - 1, cols - 1}));
+        return current.data();
+    }
+
+    // Writes the board in the bit-packed format read by snapdiff.
+    bool saveSnapshot(const std::string &path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) return false;
+        SnapshotHeader h = makeSnapshotHeader(rows, cols);
+        out.write((const char *)&h, sizeof h);
+        thawAll();
+        std::vector<uint64_t> words(h.wordsPerRow);
+        for (int i = 0; i < rows; ++i) {
+            const uint8_t *r = &current[(size_t)i * cols];
+            std::fill(words.begin(), words.end(), 0);
+            for (int j = 0; j < cols; ++j)
+                words[j >> 6] |= (uint64_t)r[j] << (j & 63);
+            out.write((const char *)words.data(), words.size() * sizeof(uint64_t));
+        }
+        return (bool)out;
+    }
+
+    // Replaces the board with a snapshot of the same dimensions.
+    bool loadSnapshot(const std::string &path, std::string *error = nullptr) {
+        MappedSnapshot snap;
+        std::string msg;
+        if (!snap.open(path))
+            msg = snap.error();
+        else if ((int)snap.header().rows != rows || (int)snap.header().cols != cols)
+            msg = path + ": board is " + std::to_string(snap.header().cols) + "x" +
+                  std::to_string(snap.header().rows) + ", expected " +
+                  std::to_string(cols) + "x" + std::to_string(rows);
+        if (!msg.empty()) {
+            if (error) *error = msg;
+            return false;
+        }
+        thawAll(true);
+        for (int i = 0; i < rows; ++i) {
+            const uint64_t *words = snap.row(i);
+            uint8_t *r = &current[(size_t)i * cols];
+            for (int j = 0; j < cols; ++j)
+                r[j] = (words[j >> 6] >> (j & 63)) & 1;
+        }
+        invalidateHistory();
+        return true;
+    }
+
+private:
+    int width, height, cellSize, cols, rows;
+    using Grid = std::vector<uint8_t, ZeroPageAllocator<uint8_t>>;
+    Grid current, next;
+    std::vector<uint8_t> zeroRow;  // stands in for the rows above and below the board
+    ThreadPool &pool;
+    BuiltinKernel builtin = BuiltinKernel::RowSum;
+
+    std::shared_ptr<KernelLibrary> kernelLib;
+    const life_kernel *kernel = nullptr;
+    void *kernelState = nullptr;
+
+    int tileSize = 0, tileRows = 0, tileCols = 0;
+    std::vector<TileStat> tileStats;
+    double stepMs = 0;
+
+    struct TileBounds {
+        long long live = 0;
+        CellBox box;
+    };
+    // per tile live count and box, one set for each of the two buffers
+    std::vector<TileBounds> tileBounds[2];
+    // Per tile, running live counts down its rows and across its columns,
+    // also one set per buffer: rowPrefix[b][tx * rows + i] counts the cells
+    // of tile column tx from the tile's top row through row i, and
+    // colPrefix[b][ty * cols + j] those of tile row ty from the tile's left
+    // column through column j. Pages of dead regions are never touched.
+    using Counts = std::vector<uint32_t, ZeroPageAllocator<uint32_t>>;
+    Counts rowPrefix[2], colPrefix[2];
+    int backIdx = 1;
+    CellBox liveBox, backBox;
+    long long liveCount = 0;
+    int boundsKnown = 0;  // 0: neither buffer, 1: current only, 2: both
+
+    // Population pyramid: level 0 holds the live count of each tile, and
+    // each level above sums 2x2 blocks of the one below. It is kept in step
+    // with the per-tile counts that stepping measures anyway.
+    struct PopLevel {
+        int rows, cols;
+        std::vector<long long> live;
+    };
+    std::vector<PopLevel> popLevels;
+    bool popValid = false;
+
+    // Tiles outside `active` are dead in both buffers, so only tiles inside
+    // it can have changed; sleeping ones keep their count from two
+    // generations back, which is their count now.
+    void updatePopulationIndex(const std::vector<TileBounds> &bounds, const CellBox &active) {
+        if (!popValid) {
+            for (int t = 0; t < tileRows * tileCols; ++t) popLevels[0].live[t] = bounds[t].live;
+            for (size_t k = 1; k < popLevels.size(); ++k) {
+                PopLevel &up = popLevels[k], &lo = popLevels[k - 1];
+                std::fill(up.live.begin(), up.live.end(), 0);
+                for (int y = 0; y < lo.rows; ++y)
+                    for (int x = 0; x < lo.cols; ++x)
+                        up.live[(size_t)(y / 2) * up.cols + x / 2] += lo.live[(size_t)y * lo.cols + x];
+            }
+            popValid = true;
+            return;
+        }
+        if (active.empty()) return;
+        for (int ty = active.top / tileSize; ty <= active.bottom / tileSize; ++ty)
+            for (int tx = active.left / tileSize; tx <= active.right / tileSize; ++tx) {
+                long long d = bounds[ty * tileCols + tx].live - popLevels[0].live[ty * tileCols + tx];
+                if (!d) continue;
+                for (size_t k = 0; k < popLevels.size(); ++k)
+                    popLevels[k].live[(size_t)(ty >> k) * popLevels[k].cols + (tx >> k)] += d;
+            }
+    }
+
+    long long populationNode(int k, int y, int x, const CellBox &r) const {
+        const PopLevel &lv = popLevels[k];
+        long long live = lv.live[(size_t)y * lv.cols + x];
+        if (!live) return 0;
+        int span = tileSize << k;
+        CellBox node{y * span, x * span, std::min(rows, (y + 1) * span) - 1, std::min(cols, (x + 1) * span) - 1};
+        CellBox in = node.clipped(r);
+        if (in.empty()) return 0;
+        if (in.top == node.top && in.left == node.left && in.bottom == node.bottom && in.right == node.right)
+            return live;
+        if (k == 0) return tileCount(y, x, node, in);
+        const PopLevel &lo = popLevels[k - 1];
+        long long sum = 0;
+        for (int cy = 2 * y; cy <= std::min(lo.rows - 1, 2 * y + 1); ++cy)
+            for (int cx = 2 * x; cx <= std::min(lo.cols - 1, 2 * x + 1); ++cx)
+                sum += populationNode(k - 1, cy, cx, r);
+        return sum;
+    }
+
+    // Live cells of `in`, a part of tile (ty, tx) that covers `tile`. Whole
+    // rows or whole columns of the tile come from its prefix counts; only a
+    // part cut on both axes, at a corner of the query, is counted directly.
+    long long tileCount(int ty, int tx, const CellBox &tile, const CellBox &in) const {
+        const int cur = backIdx ^ 1;  // the set measured for the current generation
+        if (in.left == tile.left && in.right == tile.right) {
+            const uint32_t *p = &rowPrefix[cur][(size_t)tx * rows];
+            return (long long)p[in.bottom] - (in.top > tile.top ? p[in.top - 1] : 0);
+        }
+        if (in.top == tile.top && in.bottom == tile.bottom) {
+            const uint32_t *p = &colPrefix[cur][(size_t)ty * cols];
+            return (long long)p[in.right] - (in.left > tile.left ? p[in.left - 1] : 0);
+        }
+        return countCells(in);
+    }
+
+    long long countCells(const CellBox &r) const {
+        thawRect(r);
+        long long n = 0;
+        for (int i = r.top; i <= r.bottom; ++i) {
+            const uint8_t *row = &current[(size_t)i * cols];
+            int pop = 0;
+            for (int j = r.left; j <= r.right; ++j) pop += row[j];
+            n += pop;
+        }
+        return n;
+    }
+
+    //
+    // Page release, every kReleaseInterval steps on page-allocated boards.
+    // A page of either buffer whose tiles are all dead in that buffer reads
+    // the same from the shared zero page, so it goes back to the OS; only
+    // dead tiles that will sleep or idle through the next step are counted,
+    // so stepping does not fault the page straight back in. A page whose
+    // tiles and their neighbours have all slept for coldAfter generations is
+    // packed instead, both buffers together, since a sleeping tile needs
+    // generation t-1 as much as t. The packing runs on a background thread
+    // between ticks; the page is dropped when the next tick commits it.
+    // Anything that steps or writes a cold page unpacks it for good. A reader
+    // unpacks only the current buffer and keeps the packed copy, so the page
+    // stays cold and the next step drops it again without repacking.
+    //
+    static constexpr int kReleaseInterval = 32;
+    static constexpr size_t kColdBatch = 8192;  // pages packed per tick
+    int sinceRelease = 0;
+
+    enum : uint8_t { kPageWarm, kPageEncoding, kPageFrozen, kPageShared };  // shared: frozen, unpacked for reading
+    struct ColdPage {
+        std::vector<uint8_t> packed[2];  // one per block
+    };
+    struct ColdJob {
+        size_t page;
+        ColdPage data;
+        bool ok;
+    };
+    // current and next swap buffers every step; blocks are the two
+    // allocations themselves, which never move
+    uint8_t *block[2] = {nullptr, nullptr};
+    int coldAfter = 256;
+    std::vector<uint16_t> quietGens;  // per tile: generations since it last changed
+
+    // Reading a cold page unpacks it, so const readers change this state.
+    mutable std::vector<uint8_t> pageState;  // per page index, empty when not page-allocated
+    mutable std::unordered_map<size_t, ColdPage> coldPages;
+    mutable size_t coldBytes = 0, coldPending = 0;  // coldPending: pages not warm
+    mutable std::vector<size_t> sharedPages;  // may hold pages since unpacked for good
+    mutable std::vector<ColdJob> coldBatch;  // owned by the packer while coldBusy
+    mutable bool coldPosted = false;
+    mutable std::mutex coldMutex;
+    mutable std::condition_variable coldCv;
+    bool coldBusy = false, coldStop = false;
+    std::thread coldThread;
+
+    void releasePages() {
+        if (boundsKnown < 2 || pageState.empty()) return;
+        waitCold();
+        const size_t ps = pageSize(), full = current.size() / ps;
+
+        // settled: generations the tile and all its neighbours have gone unchanged
+        std::vector<uint16_t> settled(tileRows * tileCols);
+        for (int ty = 0; ty < tileRows; ++ty)
+            for (int tx = 0; tx < tileCols; ++tx) {
+                uint16_t q = 65535;
+                for (int y = std::max(0, ty - 1); y <= std::min(tileRows - 1, ty + 1); ++y)
+                    for (int x = std::max(0, tx - 1); x <= std::min(tileCols - 1, tx + 1); ++x)
+                        q = std::min(q, quietGens[y * tileCols + x]);
+                settled[ty * tileCols + tx] = q;
+            }
+        CellBox stepsNext = liveBox.grown(1, rows, cols);
+        std::vector<int> flagged((size_t)tileRows * (tileCols + 1));
+        auto flag = [&](std::vector<int> &prefix, auto bad) {
+            for (int ty = 0; ty < tileRows; ++ty) {
+                int *row = &prefix[(size_t)ty * (tileCols + 1)];
+                row[0] = 0;
+                for (int tx = 0; tx < tileCols; ++tx) row[tx + 1] = row[tx] + (bad(ty * tileCols + tx) ? 1 : 0);
+            }
+        };
+
+        for (int b = 0; b < 2; ++b) {
+            const std::vector<TileBounds> &tb = tileBounds[block[b] == current.data() ? backIdx ^ 1 : backIdx];
+            flag(flagged, [&](int t) {
+                return tb[t].live > 0 ||
+                       (settled[t] < 1 && !tileRect(t / tileCols, t % tileCols, 1).clipped(stepsNext).empty());
+            });
+            size_t run = full;  // first page of the dead run being gathered
+            for (size_t p = 0; p <= full; ++p) {
+                if (p < full && pageState[p] == kPageWarm && pageClear(p, flagged)) {
+                    if (run == full) run = p;
+                } else if (run != full) {
+                    pageDiscard(block[b] + run * ps, (p - run) * ps);
+                    run = full;
+                }
+            }
+        }
+
+        if (!coldAfter) return;
+        const std::vector<TileBounds> &now = tileBounds[backIdx ^ 1], &back = tileBounds[backIdx];
+        std::vector<int> live((size_t)tileRows * (tileCols + 1));
+        flag(live, [&](int t) { return now[t].live > 0 || back[t].live > 0; });
+        flag(flagged, [&](int t) { return settled[t] < coldAfter; });
+        for (size_t p = 0; p < full && coldBatch.size() < kColdBatch; ++p)
+            if (pageState[p] == kPageWarm && !pageClear(p, live) && pageClear(p, flagged)) {
+                coldBatch.push_back({p, {}, false});
+                pageState[p] = kPageEncoding;
+                ++coldPending;
+            }
+        if (coldBatch.empty()) return;
+        if (!coldThread.joinable()) coldThread = std::thread([this] { packLoop(); });
+        {
+            std::lock_guard<std::mutex> lk(coldMutex);
+            coldBusy = true;
+        }
+        coldPosted = true;
+        coldCv.notify_all();
+    }
+
+    // Whether no tile under page p is flagged in `prefix`, which holds per
+    // tile row running counts of flagged tiles. A page covers the tail of
+    // one row, any whole rows after it, and the head of the next.
+    bool pageClear(size_t p, const std::vector<int> &prefix) const {
+        const size_t ps = pageSize(), s = p * ps, e = s + ps - 1;
+        int r0 = (int)(s / cols), c0 = (int)(s % cols), r1 = (int)(e / cols), c1 = (int)(e % cols);
+        auto clear = [&](int top, int left, int bottom, int right) {
+            for (int ty = top / tileSize; ty <= bottom / tileSize; ++ty) {
+                const int *row = &prefix[(size_t)ty * (tileCols + 1)];
+                if (row[right / tileSize + 1] != row[left / tileSize]) return false;
+            }
+            return true;
+        };
+        if (r0 == r1) return clear(r0, c0, r0, c1);
+        return clear(r0, c0, r0, cols - 1) && (r1 == r0 + 1 || clear(r0 + 1, 0, r1 - 1, cols - 1)) &&
+               clear(r1, 0, r1, c1);
+    }
+
+    void packLoop() {
+        const size_t ps = pageSize();
+        std::unique_lock<std::mutex> lk(coldMutex);
+        for (;;) {
+            coldCv.wait(lk, [this] { return coldBusy || coldStop; });
+            if (coldStop) return;
+            lk.unlock();
+            for (ColdJob &j : coldBatch) {
+                j.ok = true;
+                for (int b = 0; b < 2 && j.ok; ++b)
+                    j.ok = encodeCellPage(block[b] + j.page * ps, ps, j.data.packed[b]);
+            }
+            lk.lock();
+            coldBusy = false;
+            coldCv.notify_all();
+        }
+    }
+
+    // Waits for the posted batch and commits it. Pages still marked as
+    // encoding are dropped; ones taken back meanwhile stay as they are.
+    void waitCold() const {
+        if (!coldPosted) return;
+        {
+            std::unique_lock<std::mutex> lk(coldMutex);
+            coldCv.wait(lk, [this] { return !coldBusy; });
+        }
+        coldPosted = false;
+        const size_t ps = pageSize();
+        for (ColdJob &j : coldBatch) {
+            if (pageState[j.page] != kPageEncoding) continue;
+            if (!j.ok) {
+                pageState[j.page] = kPageWarm;
+                --coldPending;
+                continue;
+            }
+            for (int b = 0; b < 2; ++b) {
+                coldBytes += j.data.packed[b].size();
+                pageDiscard(block[b] + j.page * ps, ps);
+            }
+            pageState[j.page] = kPageFrozen;
+            coldPages[j.page] = std::move(j.data);
+        }
+        coldBatch.clear();
+    }
+
+    int currentBlock() const { return current.data() == block[0] ? 0 : 1; }
+
+    void thawPage(size_t p) const {
+        auto it = coldPages.find(p);
+        const size_t ps = pageSize();
+        for (int b = 0; b < 2; ++b) {
+            if (pageState[p] != kPageShared || b != currentBlock())
+                decodeCellPage(it->second.packed[b].data(), block[b] + p * ps, ps);
+            coldBytes -= it->second.packed[b].size();
+        }
+        coldPages.erase(it);
+        pageState[p] = kPageWarm;
+        --coldPending;
+    }
+
+    // Unpacks the current buffer of a frozen page for reading.
+    void sharePage(size_t p) const {
+        const int b = currentBlock();
+        const size_t ps = pageSize();
+        decodeCellPage(coldPages.at(p).packed[b].data(), block[b] + p * ps, ps);
+        pageState[p] = kPageShared;
+        sharedPages.push_back(p);
+    }
+
+    // Drops what readers unpacked since the last step; called before the
+    // buffers swap, while the unpacked copies are still the current ones.
+    void refreezeShared() {
+        const size_t ps = pageSize();
+        for (size_t p : sharedPages)
+            if (pageState[p] == kPageShared) {
+                pageDiscard(block[currentBlock()] + p * ps, ps);
+                pageState[p] = kPageFrozen;
+            }
+        sharedPages.clear();
+    }
+
+    // Unpacks the cold pages under r. A caller about to write there (or to
+    // hand r to stepping, which the packer must not race) unpacks them for
+    // good and also takes back pages still being packed, waiting for the
+    // packer to let go of them. A reader leaves them cold.
+    void thawRect(const CellBox &r, bool writing = false) const {
+        if (!coldPending || r.empty()) return;
+        const size_t ps = pageSize();
+        bool takenBack = false;
+        size_t from = 0;
+        for (int i = r.top; i <= r.bottom; ++i) {
+            size_t p1 = ((size_t)i * cols + r.right) / ps;
+            for (size_t p = std::max(from, ((size_t)i * cols + r.left) / ps); p <= p1; ++p) {
+                if (pageState[p] == kPageFrozen && !writing) {
+                    sharePage(p);
+                } else if (pageState[p] == kPageFrozen || (writing && pageState[p] == kPageShared)) {
+                    thawPage(p);
+                } else if (writing && pageState[p] == kPageEncoding) {
+                    pageState[p] = kPageWarm;
+                    --coldPending;
+                    takenBack = true;
+                }
+            }
+            from = p1 + 1;
+        }
+        if (takenBack) waitCold();
+    }
+
+    void thawAll(bool writing = false) const {
+        if (!coldPending) return;
+        if (!writing) {
+            for (auto &cp : coldPages)
+                if (pageState[cp.first] == kPageFrozen) sharePage(cp.first);
+            return;
+        }
+        for (auto &st : pageState)
+            if (st == kPageEncoding) {
+                st = kPageWarm;
+                --coldPending;
+            }
+        waitCold();
+        while (!coldPages.empty()) thawPage(coldPages.begin()->first);
+    }
+
+    CellBox tileRect(int ty, int tx, int n) const {
+        return {ty * tileSize, tx * tileSize,
+                std::min(rows, (ty + 1) * tileSize) - 1, std::min(cols, (tx + n) * tileSize) - 1};
+    }
+
+    // Population (per-row sums, which vectorize), live bounds and prefix
+    // counts of tile t of the freshly written back buffer, of which only the
+    // part inside `within` can be live. A dead tile's counts are left as
+    // they are; nothing reads them.
+    TileBounds measureTile(int t, const CellBox &within) {
+        TileBounds tb;
+        const int ty = t / tileCols, tx = t % tileCols;
+        CellBox tr = tileRect(ty, tx, 1), r = tr.clipped(within);
+        if (r.empty()) return tb;
+        uint32_t *rowSum = &rowPrefix[backIdx][(size_t)tx * rows];
+        uint32_t *colSum = &colPrefix[backIdx][(size_t)ty * cols];
+        std::fill(colSum + tr.left, colSum + tr.right + 1, 0);
+        std::fill(rowSum + tr.top, rowSum + r.top, 0);
+        for (int i = r.top; i <= r.bottom; ++i) {
+            const uint8_t *row = &next[(size_t)i * cols];
+            int pop = 0;
+            for (int j = r.left; j <= r.right; ++j) {
+                pop += row[j];
+                colSum[j] += row[j];
+            }
+            rowSum[i] = (uint32_t)(tb.live + pop);
+            if (!pop) continue;
+            int lo = r.left, hi = r.right;
+            while (!row[lo]) ++lo;
+            while (!row[hi]) --hi;
+            tb.live += pop;
+            tb.box.add({i, lo, i, hi});
+        }
+        std::fill(rowSum + r.bottom + 1, rowSum + tr.bottom + 1, (uint32_t)tb.live);
+        for (int j = tr.left + 1; j <= tr.right; ++j) colSum[j] += colSum[j - 1];
+        return tb;
+    }
+
+    // per tile: did the last step change anything versus two generations back
+    std::vector<uint8_t> changedPrev, changedNow;
+    bool historyValid = false;
+    int sleepingTiles = 0;
+
+    bool asleep(int ty, int tx, int n) const {
+        for (int y = std::max(0, ty - 1); y <= std::min(tileRows - 1, ty + 1); ++y)
+            for (int x = std::max(0, tx - 1); x <= std::min(tileCols - 1, tx + n); ++x)
+                if (changedPrev[y * tileCols + x]) return false;
+        return true;
+    }
+
+    // Writes the rect of the next generation; returns whether it differs
+    // from what the back buffer held (generation t-1).
+    bool stepRect(int i0, int i1, int j0, int j1) {
+        uint8_t diff = 0;
+        if (kernel) {
+            static thread_local std::vector<uint8_t> old;
+            int w = j1 - j0;
+            old.resize((size_t)(i1 - i0) * w);
+            for (int i = i0; i < i1; ++i)
+                std::copy_n(&next[(size_t)i * cols + j0], w, &old[(size_t)(i - i0) * w]);
+            kernel->step_band(kernelState, current.data(), next.data(), rows, cols, i0, i1, j0, j1);
+            for (int i = i0; i < i1 && !diff; ++i)
+                diff = !std::equal(old.begin() + (size_t)(i - i0) * w, old.begin() + (size_t)(i - i0 + 1) * w,
+                                   next.begin() + (size_t)i * cols + j0);
+            return diff;
+        }
+        if (builtin == BuiltinKernel::RowSum)
+            return stepRectRowSum(i0, i1, j0, j1);
+        for (int i = i0; i < i1; ++i)
+            for (int j = j0; j < j1; ++j) {
+                int n = countNeighbors(i, j);
+                size_t k = (size_t)i * cols + j;
+                uint8_t v = current[k] ? (n == 2 || n == 3) : (n == 3);
+                diff |= next[k] ^ v;
+                next[k] = v;
+            }
+        return diff;
+    }
+
+    bool stepRectRowSum(int i0, int i1, int j0, int j1) {
+        return stepBandRowSum(current.data(), next.data(), rows, cols, i0, i1, j0, j1, zeroRow.data());
+    }
+
+    int countNeighbors(int x, int y) const {
+        int c = 0;
+        for (int dx = -1; dx <= 1; ++dx)
+            for (int dy = -1; dy <= 1; ++dy)
+                if (!(dx == 0 && dy == 0)) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx >= 0 && nx < rows && ny >= 0 && ny < cols)
+                        c += current[(size_t)nx * cols + ny];
+                }
+        return c;
+    }
+};
+
+//
+// ---------- Period Detector ----------
+//
+// Hashes the live region relative to its bounding box, so a pattern that
+// reappears shifted (a spaceship) matches its earlier self just like an
+// oscillator does. The offset between the two boxes gives the displacement.
+struct PeriodInfo {
+    bool found = false;
+    long long period = 0;
+    int dx = 0, dy = 0;
+};
+
+class PeriodDetector {
+public:
+    explicit PeriodDetector(size_t window = 4096) : window(window) {}
+
+    // Records generation `gen`; returns true while the board repeats an
+    // earlier (possibly translated) state within the history window.
+    bool observe(const LifeAccel &life, long long gen) {
+        CellBox box = life.getBounds();
+        int top = box.top, left = box.left, bottom = box.bottom, right = box.right;
+        if (box.empty()) {
+            info = PeriodInfo{};
+            extinct = true;
+            return false;
+        }
+        extinct = false;
+
+        uint64_t h = mix(0x9e3779b97f4a7c15ull, (uint64_t)(bottom - top) << 32 | (uint32_t)(right - left));
+        for (int i = top; i <= bottom; ++i)
+            for (int j = left; j <= right; ++j)
+                if (life.alive(i, j))
+                    h = mix(h, (uint64_t)(i - top) << 32 | (uint32_t)(j - left));
+
+        auto it = seen.find(h);
+        if (it != seen.end()) {
+            info.found = true;
+            info.period = gen - it->second.gen;
+            info.dx = left - it->second.left;
+            info.dy = top - it->second.top;
+        } else {
+            info = PeriodInfo{};
+        }
+        seen[h] = {gen, top, left};
+        order.push_back({h, gen});
+        while (order.size() > window) {
+            auto old = seen.find(order.front().first);
+            if (old != seen.end() && old->second.gen == order.front().second)
+                seen.erase(old);
+            order.pop_front();
+        }
+        return info.found;
+    }
+
+    const PeriodInfo &result() const { return info; }
+
+    // Short classification, e.g. "p2 oscillator" or "c/2 orthogonal ship (p4)".
+    std::string describe() const {
+        if (extinct) return "extinct";
+        if (!info.found) return "-";
+        if (info.dx == 0 && info.dy == 0)
+            return info.period == 1 ? "still life" : "p" + std::to_string(info.period) + " oscillator";
+        int ax = std::abs(info.dx), ay = std::abs(info.dy);
+        long long d = std::max(ax, ay), g = std::gcd(d, info.period);
+        std::string speed = (d == g ? "" : std::to_string(d / g)) + "c/" + std::to_string(info.period / g);
+        const char *dir = (ax == 0 || ay == 0) ? "orthogonal" : (ax == ay ? "diagonal" : "oblique");
+        return speed + " " + dir + " ship (p" + std::to_string(info.period) + ")";
+    }
+
+    void reset() {
+        seen.clear();
+        order.clear();
+        info = PeriodInfo{};
+        extinct = false;
+    }
+
+private:
+    struct Seen { long long gen; int top, left; };
+    size_t window;
+    std::unordered_map<uint64_t, Seen> seen;
+    std::deque<std::pair<uint64_t, long long>> order;
+    PeriodInfo info;
+    bool extinct = false;
+
+    static uint64_t mix(uint64_t h, uint64_t v) {
+        h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        h ^= h >> 31;
+        return h * 0xbf58476d1ce4e5b9ull;
+    }
+};
@@ -0,0 +1,98 @@
+#include "life_capi.h"
+#include "life_accel.hpp"
+
+//
+// ---------- C API ----------
+//
+struct life_engine {
+    ThreadPool pool;
+    LifeAccel life;
+    PeriodDetector period;
+    long long gen = 0;
+    int live = 0, delta = 0;
+    std::string error;
+
+    life_engine(int cols, int rows, size_t threads)
+        : pool(threads), life(cols, rows, 1, pool) {}
+
+    void resetCounters() {
+        gen = 0;
+        live = life.getLiveCount();
+        delta = 0;
+        period.reset();
+    }
+};
+
+uint32_t life_api_version(void) { return LIFE_API_VERSION; }
+
+life_engine *life_create(int32_t cols, int32_t rows, int32_t threads) {
+    if (cols <= 0 || rows <= 0) return nullptr;
+    size_t n = threads > 0 ? (size_t)threads : std::max(1u, std::thread::hardware_concurrency());
+    try {
+        return new life_engine(cols, rows, n);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void life_destroy(life_engine *e) { delete e; }
+
+void life_randomize(life_engine *e, double fill) {
+    e->life.randomize(fill);
+    e->resetCounters();
+}
+
+void life_step(life_engine *e, int32_t generations) {
+    for (int32_t g = 0; g < generations; ++g) {
+        e->life.updateParallel();
+        int live = e->life.getLiveCount();
+        e->delta = live - e->live;
+        e->live = live;
+        e->period.observe(e->life, ++e->gen);
+    }
+}
+
+int32_t life_load_snapshot(life_engine *e, const char *path) {
+    if (!e->life.loadSnapshot(path, &e->error)) return -1;
+    e->resetCounters();
+    return 0;
+}
+
+int32_t life_save_snapshot(life_engine *e, const char *path) {
+    if (e->life.saveSnapshot(path)) return 0;
+    e->error = std::string("cannot write ") + path;
+    return -1;
+}
+
+const char *life_last_error(const life_engine *e) { return e->error.c_str(); }
+
+uint8_t *life_cells(life_engine *e, int32_t *rows, int32_t *cols) {
+    if (rows) *rows = e->life.getRows();
+    if (cols) *cols = e->life.getCols();
+    return e->life.cells();
+}
+
+const uint8_t *life_cells_view(const life_engine *e, int32_t *rows, int32_t *cols) {
+    if (rows) *rows = e->life.getRows();
+    if (cols) *cols = e->life.getCols();
+    return e->life.cells();
+}
+
+void life_get_metrics(const life_engine *e, life_metrics *out) {
+    const PeriodInfo &p = e->period.result();
+    out->generation = e->gen;
+    out->live = e->live;
+    out->delta = e->delta;
+    out->step_ms = e->life.getStepMs();
+    out->period = p.found ? p.period : 0;
+    out->dx = p.dx;
+    out->dy = p.dy;
+    out->sleeping_tiles = e->life.getSleepingTiles();
+    out->tiles = e->life.getTileCount();
+}
+
+int64_t life_population(const life_engine *e, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (w <= 0 || h <= 0) return 0;
+    return e->life.populationIn({y, x, (int)std::min<int64_t>(INT32_MAX, (int64_t)y + h - 1),
+                                 (int)std::min<int64_t>(INT32_MAX, (int64_t)x + w - 1)});
+}
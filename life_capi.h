@@ -0,0 +1,74 @@
+#ifndef LIFE_CAPI_H
+#define LIFE_CAPI_H
+
+/*
+ * Stable C interface to the LifeAccel engine.
+ *
+ * Bump LIFE_API_VERSION on any incompatible change; callers should compare
+ * it against life_api_version() before use.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(LIFE_BUILD_DLL)
+#    define LIFE_API __declspec(dllexport)
+#  else
+#    define LIFE_API __declspec(dllimport)
+#  endif
+#else
+#  define LIFE_API __attribute__((visibility("default")))
+#endif
+
+#define LIFE_API_VERSION 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct life_engine life_engine;
+
+typedef struct {
+    int64_t generation;
+    int64_t live;
+    int64_t delta;
+    double step_ms;
+    /* last detected repeat; period is 0 when none */
+    int64_t period;
+    int32_t dx, dy;
+    /* tiles skipped by the last step as still or period 2 */
+    int32_t sleeping_tiles, tiles;
+} life_metrics;
+
+LIFE_API uint32_t life_api_version(void);
+
+/* threads <= 0 uses one worker per hardware thread */
+LIFE_API life_engine *life_create(int32_t cols, int32_t rows, int32_t threads);
+LIFE_API void life_destroy(life_engine *e);
+
+LIFE_API void life_randomize(life_engine *e, double fill);
+LIFE_API void life_step(life_engine *e, int32_t generations);
+
+/* return 0 on success, -1 on error (see life_last_error) */
+LIFE_API int32_t life_load_snapshot(life_engine *e, const char *path);
+LIFE_API int32_t life_save_snapshot(life_engine *e, const char *path);
+LIFE_API const char *life_last_error(const life_engine *e);
+
+/*
+ * Row-major, one byte per cell (0 or 1), writable in place. The pointer is
+ * invalidated by life_step and life_destroy. Taking it wakes every tile, so
+ * use life_cells_view when only reading.
+ */
+LIFE_API uint8_t *life_cells(life_engine *e, int32_t *rows, int32_t *cols);
+LIFE_API const uint8_t *life_cells_view(const life_engine *e, int32_t *rows, int32_t *cols);
+
+LIFE_API void life_get_metrics(const life_engine *e, life_metrics *out);
+
+/* live cells in the rect of w x h cells at column x, row y (clipped) */
+LIFE_API int64_t life_population(const life_engine *e, int32_t x, int32_t y, int32_t w, int32_t h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
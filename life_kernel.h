@@ -0,0 +1,43 @@
+#ifndef LIFE_KERNEL_H
+#define LIFE_KERNEL_H
+
+/*
+ * Kernel plugin ABI.
+ *
+ * A plugin is a shared library exporting LIFE_KERNEL_ENTRY, which returns a
+ * pointer to a static life_kernel table. LifeAccel refuses tables whose
+ * abi_version differs from LIFE_KERNEL_ABI_VERSION.
+ */
+
+#include <stdint.h>
+
+#define LIFE_KERNEL_ABI_VERSION 1
+#define LIFE_KERNEL_ENTRY "life_kernel_entry"
+
+/* step_band may run concurrently on disjoint regions of the same board */
+#define LIFE_KERNEL_CAP_REENTRANT 0x1u
+/* step_band accepts column ranges narrower than the board */
+#define LIFE_KERNEL_CAP_SUBRECT 0x2u
+
+typedef struct life_kernel {
+    uint32_t abi_version;
+    const char *name;
+    uint32_t capabilities;
+
+    /* Per-board state, called once per board size; may return NULL. */
+    void *(*init)(int32_t rows, int32_t cols);
+    void (*shutdown)(void *state);
+
+    /*
+     * Writes next[r][c] for rows [row0, row1) and columns [col0, col1) from
+     * cur. Both grids are rows x cols, row-major, one byte (0 or 1) per cell;
+     * cells outside the board are dead.
+     */
+    void (*step_band)(void *state, const uint8_t *cur, uint8_t *next,
+                      int32_t rows, int32_t cols,
+                      int32_t row0, int32_t row1, int32_t col0, int32_t col1);
+} life_kernel;
+
+typedef const life_kernel *(*life_kernel_entry_fn)(void);
+
+#endif
@@ -0,0 +1,81 @@
+#include "session_host.hpp"
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+//
+// ---------- lifehost ----------
+//
+// usage: lifehost --session NAME:WxH[:weight[:cpu[:memMB]]] ...
+//                 [--budget MB] [--seconds S] [--threads N]
+// Runs each session as a random soup on one shared pool and prints a
+// metrics line per session every second. `cpu` is the session's cap on its
+// share of pool time (0-1]; `memMB` caps its grids.
+//
+int main(int argc, char **argv) {
+    std::vector<SessionConfig> configs;
+    size_t budgetMB = 4096;
+    double seconds = 10;
+    size_t threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "--session" && more) {
+            std::string spec = argv[++i];
+            SessionConfig c;
+            char name[64] = {};
+            double memMB = 0;
+            int n = std::sscanf(spec.c_str(), "%63[^:]:%dx%d:%lf:%lf:%lf", name, &c.cols, &c.rows, &c.weight,
+                                &c.cpuQuota, &memMB);
+            if (n < 3) {
+                std::cerr << "bad session spec " << spec << "\n";
+                return 2;
+            }
+            c.name = name;
+            c.memQuota = (size_t)(memMB * 1048576);
+            configs.push_back(c);
+        } else if (a == "--budget" && more) budgetMB = std::stoul(argv[++i]);
+        else if (a == "--seconds" && more) seconds = std::stod(argv[++i]);
+        else if (a == "--threads" && more) threads = std::stoul(argv[++i]);
+        else {
+            configs.clear();
+            break;
+        }
+    }
+    if (configs.empty()) {
+        std::cerr << "usage: lifehost --session NAME:WxH[:weight[:cpu[:memMB]]] ..."
+                     " [--budget MB] [--seconds S] [--threads N]\n";
+        return 2;
+    }
+
+    ThreadPool pool(threads);
+    SessionHost host(pool, budgetMB << 20);
+    for (const SessionConfig &c : configs) {
+        std::string err;
+        int id = host.add(c, &err);
+        if (id < 0) {
+            std::cerr << "not started: " << err << "\n";
+            continue;
+        }
+        host.with(id, [](LifeAccel &life) { life.randomize(0.3); });
+    }
+
+    host.start();
+    auto t0 = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() < seconds) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::cout << std::left << std::setw(12) << "session" << std::right << std::setw(10) << "gen"
+                  << std::setw(10) << "steps/s" << std::setw(8) << "cpu%" << std::setw(10) << "ms/step"
+                  << std::setw(10) << "live" << std::setw(10) << "MB" << std::setw(10) << "throttled" << "\n";
+        for (const SessionMetrics &m : host.metrics())
+            std::cout << std::left << std::setw(12) << m.name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << m.generation << std::setw(10) << m.stepsPerSec << std::setw(8)
+                      << m.cpuShare * 100 << std::setprecision(3) << std::setw(10) << m.stepMs << std::setw(10)
+                      << m.live << std::setprecision(1) << std::setw(10) << m.residentBytes / 1048576.0
+                      << std::setw(10) << m.throttled << "\n";
+        std::cout << "\n";
+    }
+    host.stop();
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "mpi_engine.hpp"
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+//
+// ---------- lifempi ----------
+//
+// usage: mpirun -np N lifempi [-n gens] [--size WxH] [--density D] [--seed S]
+//                             [--threads T] [--check] [--snapshot out.snap]
+// Runs a seeded soup on the MPI engine. Every rank seeds its own block from
+// a hash of the cell coordinates, so nothing is scattered at start-up.
+// Rank 0 reports the process grid, time per generation and how much of it
+// went to waiting for the halo. --check has rank 0 also run the whole board
+// on LifeAccel and compare population and fingerprint, which is how the
+// engine is tested under mpirun on a single machine.
+//
+int main(int argc, char **argv) {
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    long long gens = 100;
+    int w = 4096, h = 4096;
+    double density = 0.3;
+    uint64_t seed = 1;
+    size_t threads = 0;
+    bool check = false;
+    std::string snapshot;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "-n" && more) gens = std::stoll(argv[++i]);
+        else if (a == "--size" && more && std::sscanf(argv[++i], "%dx%d", &w, &h) == 2) {}
+        else if (a == "--density" && more) density = std::stod(argv[++i]);
+        else if (a == "--seed" && more) seed = std::stoull(argv[++i]);
+        else if (a == "--threads" && more) threads = std::stoul(argv[++i]);
+        else if (a == "--check") check = true;
+        else if (a == "--snapshot" && more) snapshot = argv[++i];
+        else {
+            if (rank == 0)
+                std::cerr << "usage: mpirun -np N lifempi [-n gens] [--size WxH] [--density D] [--seed S]"
+                             " [--threads T] [--check] [--snapshot out.snap]\n";
+            MPI_Finalize();
+            return 2;
+        }
+    }
+
+    // by default the cores of this machine are shared among its ranks
+    if (!threads) {
+        MPI_Comm node;
+        int local;
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+        MPI_Comm_size(node, &local);
+        MPI_Comm_free(&node);
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency() / local);
+    }
+
+    const uint64_t threshold = (uint64_t)(density * 18446744073709551615.0);
+    auto soup = [&](int r, int c) { return mixCell(r, c + (seed << 32)) < threshold; };
+
+    int status = 0;
+    {
+        ThreadPool pool(threads);
+        MpiLife life(MPI_COMM_WORLD, pool);
+        std::string err;
+        if (!life.open(h, w, &err)) {
+            if (rank == 0) std::cerr << err << "\n";
+            MPI_Finalize();
+            return 2;
+        }
+        life.fill(soup);
+
+        double stepMs = 0, haloMs = 0;
+        MPI_Barrier(MPI_COMM_WORLD);
+        double t0 = MPI_Wtime();
+        for (long long g = 0; g < gens; ++g) {
+            life.step();
+            stepMs += life.getStepMs();
+            haloMs += life.getHaloMs();
+        }
+        double wall = (MPI_Wtime() - t0) * 1000;
+        double maxHalo = 0;
+        MPI_Reduce(&haloMs, &maxHalo, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        long long pop = life.population();
+        uint64_t print = life.fingerprint();
+
+        if (rank == 0) {
+            int p, q;
+            life.getProcessGrid(p, q);
+            double perGen = gens ? wall / gens : 0;
+            std::cout << std::fixed << std::setprecision(3)
+                      << w << "x" << h << " on " << p << "x" << q << " ranks, " << threads << " threads each\n"
+                      << perGen << " ms/gen, halo arrived after " << (gens ? maxHalo / gens : 0)
+                      << " ms/gen (slowest rank), " << std::setprecision(1)
+                      << (perGen > 0 ? (double)w * h / perGen / 1000 : 0) << " Mcells/s\n"
+                      << "population " << pop << ", fingerprint " << std::hex << print << std::dec << "\n";
+        }
+
+        if (!snapshot.empty() && !life.saveSnapshot(snapshot, &err)) {
+            if (rank == 0) std::cerr << err << "\n";
+            status = 2;
+        }
+
+        if (check) {
+            int same = 1;
+            if (rank == 0) {
+                LifeAccel ref(w, h, 1, pool);
+                uint8_t *cells = ref.cells();
+                for (int r = 0; r < h; ++r)
+                    for (int c = 0; c < w; ++c) cells[(size_t)r * w + c] = soup(r, c);
+                for (long long g = 0; g < gens; ++g) ref.updateParallel();
+                uint64_t refPrint = 0;
+                const uint8_t *cur = ref.cells();
+                for (int r = 0; r < h; ++r)
+                    for (int c = 0; c < w; ++c)
+                        if (cur[(size_t)r * w + c]) refPrint += mixCell(r, c);
+                same = ref.getLiveCount() == pop && refPrint == print;
+                std::cout << (same ? "check: matches LifeAccel\n" : "check: MISMATCH with LifeAccel\n");
+            }
+            MPI_Bcast(&same, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            if (!same) status = 1;
+        }
+    }
+    MPI_Finalize();
+    return status;
+}
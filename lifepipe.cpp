@@ -0,0 +1,75 @@
+#include "frame_stream.hpp"
+#include "pattern_store.hpp"
+#include <cstdio>
+#include <csignal>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+//
+// ---------- lifepipe ----------
+//
+// usage: lifepipe [-n gens] [--size WxH] [--keyframe K] [--threads N]
+//                 < pattern.rle > stream.bin
+// Reads an RLE or Macrocell pattern on stdin, centres it on the board (by
+// default the pattern plus a 64-cell margin) and writes generation 0 onward
+// to stdout in the frame stream format. --keyframe 0 writes every
+// generation as a full frame; otherwise deltas with a frame every K. Runs
+// until -n generations are written or the reader closes the pipe.
+//
+int main(int argc, char **argv) {
+    long long gens = -1;
+    int w = 0, h = 0;
+    uint32_t keyframe = 256;
+    size_t threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "-n" && more) gens = std::stoll(argv[++i]);
+        else if (a == "--size" && more && std::sscanf(argv[++i], "%dx%d", &w, &h) == 2) {}
+        else if (a == "--keyframe" && more) keyframe = (uint32_t)std::stoul(argv[++i]);
+        else if (a == "--threads" && more) threads = std::stoul(argv[++i]);
+        else {
+            std::cerr << "usage: lifepipe [-n gens] [--size WxH] [--keyframe K] [--threads N]"
+                         " < pattern > stream\n";
+            return 2;
+        }
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#else
+    std::signal(SIGPIPE, SIG_IGN);  // a closed reader shows up as a failed write
+#endif
+
+    std::string text, err;
+    char buf[1 << 16];
+    for (size_t n; (n = fread(buf, 1, sizeof buf, stdin)) > 0;) text.append(buf, n);
+    PatternBits pat;
+    if (!parsePattern(text, pat, &err)) {
+        std::cerr << "stdin: " << err << "\n";
+        return 2;
+    }
+    if (w <= 0 || h <= 0) {
+        w = (int)pat.cols + 128;
+        h = (int)pat.rows + 128;
+    }
+
+    ThreadPool pool(std::max<size_t>(1, threads));
+    LifeAccel life(w, h, 1, pool);
+    stampPattern(life, pat, (h - (int)pat.rows) / 2, (w - (int)pat.cols) / 2);
+
+    StreamWriter out(1);
+    FrameEncoder enc(out, life.getRows(), life.getCols(), keyframe);
+    for (long long g = 0; gens < 0 || g < gens; ++g) {
+        if (!enc.emit(life, g)) break;
+        life.updateParallel();
+    }
+    out.flush();
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "frame_stream.hpp"
+#include "terminal_view.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+//
+// ---------- lifeterm ----------
+//
+// usage: lifepipe < pattern.rle | lifeterm [--fps N] [--origin X,Y]
+// Watches a frame stream in the terminal. Every record is applied, but at
+// most --fps frames a second are drawn, and each draw only rewrites the
+// braille characters that changed, so it keeps up with the engine over a
+// slow SSH link. The view is centred on the board unless --origin names its
+// top-left cell.
+//
+static std::string restoreSeq;
+
+static void onInterrupt(int) {
+    fwrite(restoreSeq.data(), 1, restoreSeq.size(), stdout);
+    fflush(stdout);
+    std::_Exit(130);
+}
+
+int main(int argc, char **argv) {
+    double fps = 30;
+    int ox = INT32_MIN, oy = INT32_MIN;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "--fps" && more && std::sscanf(argv[++i], "%lf", &fps) == 1 && fps > 0) {}
+        else if (a == "--origin" && more && std::sscanf(argv[++i], "%d,%d", &ox, &oy) == 2) {}
+        else {
+            std::cerr << "usage: lifeterm [--fps N] [--origin X,Y] < stream\n";
+            return 2;
+        }
+    }
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+
+    FrameStreamReader in(stdin);
+    std::string err;
+    if (!in.open(&err)) {
+        std::cerr << "stdin: " << err << "\n";
+        return 2;
+    }
+    const FrameStreamHeader &h = in.header();
+
+    int tcols, trows;
+    terminalSize(tcols, trows);
+    TerminalView view(tcols, trows - 1);
+    if (ox == INT32_MIN) {
+        ox = ((int)h.cols - tcols * 2) / 2;
+        oy = ((int)h.rows - (trows - 1) * 4) / 2;
+    }
+    restoreSeq = TerminalView::restore(view.getRows());
+    std::signal(SIGINT, onInterrupt);
+
+    using clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    auto due = clock::now();
+    std::string out;
+    size_t bytes = 0;
+    bool more = true;
+    while (more) {
+        more = in.next();
+        if (more && clock::now() < due) continue;
+        due = clock::now() + interval;
+
+        std::string status = "gen " + std::to_string(in.getGeneration()) + "  live " +
+                             std::to_string(in.getLive()) + "  " + std::to_string(h.cols) + "x" +
+                             std::to_string(h.rows) + "  out " + std::to_string(bytes / 1024) + " KiB";
+        out.clear();
+        view.render([&](int r) { return in.row((uint32_t)r); }, (int)h.rows, (int)h.cols, oy, ox,
+                    status.substr(0, (size_t)tcols), out);
+        bytes += out.size();
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+    }
+    fputs(restoreSeq.c_str(), stdout);
+    return 0;
+}
@@ -1,161 +1,185 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include "life_accel.hpp"
+#include "interval_engine.hpp"
+#include "sparse_engine.hpp"
+#include "checkpoint.hpp"
+#include "rle.hpp"
+#include "pattern_store.hpp"
+#include "frame_pacer.hpp"
+#include "wireworld_engine.hpp"
+#include "continuous_engine.hpp"
 #include <vector>
-#include <thread>
-#include <mutex>
-#include <queue>
-#include <functional>
-#include <condition_variable>
-#include <chrono>
-#include <random>
 #include <string>
-#include <atomic>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 //
-// ---------- Thread Pool ----------
+// ---------- LifeAccel Rendering ----------
 //
-class ThreadPool {
-public:
-    ThreadPool(size_t n = std::thread::hardware_concurrency()) : stop(false) {
-        for (size_t i = 0; i < n; ++i)
-            workers.emplace_back([this]() { workerLoop(); });
-    }
-    ~ThreadPool() {
-        {
-            std::unique_lock<std::mutex> lock(qMutex);
-            stop = true;
-        }
-        cond.notify_all();
-        for (auto &t : workers) t.join();
-    }
-    void enqueue(std::function<void()> job) {
-        {
-            std::unique_lock<std::mutex> lock(qMutex);
-            tasks.push(std::move(job));
-        }
-        cond.notify_one();
-    }
-    void waitAll() {
-        std::unique_lock<std::mutex> lock(doneMutex);
-        doneCond.wait(lock, [this]() { return tasks.empty() && activeWorkers == 0; });
+// Appends a quad of `size` at (x, y) in `c`.
+static void appendQuad(sf::VertexArray &va, float x, float y, float size, sf::Color c) {
+    va.append(sf::Vertex(sf::Vector2f(x, y), c));
+    va.append(sf::Vertex(sf::Vector2f(x + size, y), c));
+    va.append(sf::Vertex(sf::Vector2f(x + size, y + size), c));
+    va.append(sf::Vertex(sf::Vector2f(x, y + size), c));
+}
+
+// Quads for the live cells of `box`, whose cells LifeAccel::copyCells put
+// in `cells`.
+void appendCells(sf::VertexArray &va, const CellBox &box, const std::vector<uint8_t> &cells, int cellSize) {
+    const sf::Color color(80, 200, 255);
+    const int w = box.right - box.left + 1;
+    for (int i = box.top; i <= box.bottom; ++i) {
+        const uint8_t *row = &cells[(size_t)(i - box.top) * w];
+        for (int j = 0; j < w; ++j)
+            if (row[j])
+                appendQuad(va, (float)((box.left + j) * cellSize), (float)(i * cellSize), (float)(cellSize - 1),
+                           color);
     }
+}
 
-private:
-    std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
-    std::mutex qMutex, doneMutex;
-    std::condition_variable cond, doneCond;
-    std::atomic<int> activeWorkers{0};
-    bool stop;
-
-    void workerLoop() {
-        while (true) {
-            std::function<void()> job;
-            {
-                std::unique_lock<std::mutex> lock(qMutex);
-                cond.wait(lock, [this]() { return stop || !tasks.empty(); });
-                if (stop && tasks.empty()) return;
-                job = std::move(tasks.front());
-                tasks.pop();
-                ++activeWorkers;
-            }
-            job();
-            {
-                std::unique_lock<std::mutex> lock(doneMutex);
-                --activeWorkers;
-                if (tasks.empty() && activeWorkers == 0)
-                    doneCond.notify_all();
-            }
+// Tints each tile by the worker that owned it, brighter the costlier it was.
+void LifeAccel::appendLoadOverlay(sf::VertexArray &va) const {
+    float maxMs = 0;
+    for (auto &st : tileStats) maxMs = std::max(maxMs, st.ms);
+    if (maxMs <= 0) return;
+
+    float span = (float)(tileSize * cellSize);
+    for (int ty = 0; ty < tileRows; ++ty)
+        for (int tx = 0; tx < tileCols; ++tx) {
+            const TileStat &st = tileStats[ty * tileCols + tx];
+            sf::Color c = workerColor(st.worker);
+            c.a = (sf::Uint8)(30 + 170 * (st.ms / maxMs));
+            appendQuad(va, tx * span, ty * span, span - 1, c);
         }
+}
+
+sf::Color LifeAccel::workerColor(int w) {
+    static const sf::Color palette[] = {
+        {255, 90, 90}, {90, 255, 120}, {90, 140, 255}, {255, 220, 60},
+        {230, 90, 255}, {60, 230, 230}, {255, 150, 40}, {200, 200, 200}};
+    return w < 0 ? sf::Color(255, 255, 255) : palette[w % 8];
+}
+
+// Wireworld in Golly's colours: copper amber, heads blue, tails red.
+void WireWorld::appendCopper(sf::VertexArray &va, float cellSize) const {
+    const sf::Color copper(184, 115, 51);
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            if (cells[(size_t)i * cols + j] != kWireEmpty) appendQuad(va, j * cellSize, i * cellSize, cellSize, copper);
+}
+
+void WireWorld::appendSignals(sf::VertexArray &va, float cellSize) const {
+    const sf::Color head(80, 160, 255), tail(255, 90, 60);
+    auto add = [&](size_t k) {
+        uint8_t s = cells[k];
+        if (s == kWireHead || s == kWireTail)
+            appendQuad(va, (k % cols) * cellSize, (k / cols) * cellSize, cellSize, s == kWireHead ? head : tail);
+    };
+    if (!graphValid) {
+        for (size_t k = 0; k < cells.size(); ++k) add(k);
+        return;
     }
-};
+    for (uint32_t h : heads) add(where[h]);
+    for (uint32_t t : tails) add(where[t]);
+}
 
 //
-// ---------- LifeAccel ----------
+// ---------- Minimap & Viewports ----------
 //
-class LifeAccel {
-public:
-    LifeAccel(int w, int h, int c, ThreadPool &p)
-        : width(w), height(h), cellSize(c),
-          cols(w / c), rows(h / c),
-          current(rows, std::vector<uint8_t>(cols, 0)),
-          next(rows, std::vector<uint8_t>(cols, 0)),
-          pool(p) {}
-
-    void randomize(double fill = 0.25) {
-        std::mt19937 rng(std::random_device{}());
-        std::uniform_real_distribution<double> dist(0, 1);
-        for (auto &r : current)
-            for (auto &c : r)
-                c = dist(rng) < fill ? 1 : 0;
-    }
+// A viewport shows a board region resampled into a texture of at most
+// kViewportPixels across, read from the population pyramid, so a frame costs
+// the same however large the board is. The minimap is a viewport over the
+// whole board, with the other viewports outlined on it.
+//
+constexpr int kViewportPixels = 256;
 
-    void updateParallel() {
-        int nThreads = std::thread::hardware_concurrency();
-        int chunk = rows / nThreads;
-        for (int t = 0; t < nThreads; ++t) {
-            int start = t * chunk;
-            int end = (t == nThreads - 1) ? rows : start + chunk;
-            pool.enqueue([=, this]() {
-                for (int i = start; i < end; ++i)
-                    for (int j = 0; j < cols; ++j) {
-                        int n = countNeighbors(i, j);
-                        next[i][j] = current[i][j] ? (n == 2 || n == 3) : (n == 3);
-                    }
-            });
-        }
-        pool.waitAll();
-        current.swap(next);
-    }
+struct Viewport {
+    CellBox region;        // board cells shown
+    sf::FloatRect screen;  // where on the window
+    int px = 0, py = 0;    // texture resolution
+    sf::Texture tex;
+    std::vector<uint8_t> density;
+    std::vector<sf::Uint8> rgba;
+};
 
-    void draw(sf::RenderWindow &win) const {
-        sf::RectangleShape cell(sf::Vector2f(cellSize - 1, cellSize - 1));
-        cell.setFillColor(sf::Color(80, 200, 255));
-        for (int i = 0; i < rows; ++i)
-            for (int j = 0; j < cols; ++j)
-                if (current[i][j]) {
-                    cell.setPosition(j * cellSize, i * cellSize);
-                    win.draw(cell);
-                }
-    }
+void initViewport(Viewport &vp, const CellBox &region, sf::FloatRect screen) {
+    vp.region = region;
+    vp.screen = screen;
+    vp.px = std::max(1, (int)std::min<float>(screen.width, kViewportPixels));
+    vp.py = std::max(1, (int)std::min<float>(screen.height, kViewportPixels));
+    vp.tex.create(vp.px, vp.py);
+    vp.rgba.assign((size_t)vp.px * vp.py * 4, 0);
+}
 
-    int getLiveCount() const {
-        int c = 0;
-        for (auto &r : current)
-            for (auto v : r)
-                c += v;
-        return c;
+// Resamples the board into the viewport's pixels; needs the board stable.
+void sampleViewport(const LifeAccel &life, Viewport &vp) {
+    life.renderDensity(vp.region, vp.px, vp.py, vp.density);
+}
+
+void drawViewport(sf::RenderWindow &win, Viewport &vp, const std::vector<Viewport> &outlined = {}) {
+    for (size_t i = 0; i < vp.density.size(); ++i) {
+        float d = vp.density[i] / 255.f;
+        sf::Uint8 *p = &vp.rgba[i * 4];
+        p[0] = (sf::Uint8)(12 + 68 * d);
+        p[1] = (sf::Uint8)(12 + 188 * d);
+        p[2] = (sf::Uint8)(24 + 231 * d);
+        p[3] = 230;
     }
+    vp.tex.update(vp.rgba.data());
+    sf::Sprite sprite(vp.tex);
+    sprite.setPosition(vp.screen.left, vp.screen.top);
+    sprite.setScale(vp.screen.width / vp.px, vp.screen.height / vp.py);
+    win.draw(sprite);
 
-private:
-    int width, height, cellSize, cols, rows;
-    std::vector<std::vector<uint8_t>> current, next;
-    ThreadPool &pool;
-
-    int countNeighbors(int x, int y) const {
-        int c = 0;
-        for (int dx = -1; dx <= 1; ++dx)
-            for (int dy = -1; dy <= 1; ++dy)
-                if (!(dx == 0 && dy == 0)) {
-                    int nx = x + dx, ny = y + dy;
-                    if (nx >= 0 && nx < rows && ny >= 0 && ny < cols)
-                        c += current[nx][ny];
-                }
-        return c;
+    sf::RectangleShape frame(sf::Vector2f(vp.screen.width, vp.screen.height));
+    frame.setPosition(vp.screen.left, vp.screen.top);
+    frame.setFillColor(sf::Color::Transparent);
+    frame.setOutlineColor(sf::Color(255, 200, 0));
+    frame.setOutlineThickness(1);
+    win.draw(frame);
+
+    // other viewports' regions, mapped into this one
+    float kx = vp.screen.width / (vp.region.right - vp.region.left + 1);
+    float ky = vp.screen.height / (vp.region.bottom - vp.region.top + 1);
+    for (const Viewport &o : outlined) {
+        CellBox r = o.region.clipped(vp.region);
+        if (r.empty()) continue;
+        sf::RectangleShape box(sf::Vector2f((r.right - r.left + 1) * kx, (r.bottom - r.top + 1) * ky));
+        box.setPosition(vp.screen.left + (r.left - vp.region.left) * kx, vp.screen.top + (r.top - vp.region.top) * ky);
+        box.setFillColor(sf::Color::Transparent);
+        box.setOutlineColor(sf::Color(255, 90, 90));
+        box.setOutlineThickness(1);
+        win.draw(box);
     }
-};
+}
 
 //
 // ---------- Simulation Metrics ----------
 //
 struct SimulationMetrics {
-    double fps = 0, avgFps = 0, updateMs = 0, frameMs = 0;
+    double fps = 0, avgFps = 0, updateMs = 0, frameMs = 0, frameStdMs = 0;
+    double stepsPerSec = 0, inputMs = 0;
+    long long dropped = 0;
+    bool vsync = false;
     int live = 0, delta = 0;
     long long gen = 0;
+    int tileSize = 0;
+    std::vector<double> workerUtil;
+    std::string period = "-";
+    int asleep = 0, tiles = 0;
+    std::string kernel;
+    double gridMB = 0, residentMB = 0, coldMB = 0;
+    size_t coldPages = 0;
 };
 
 void updateMetricsWindow(sf::RenderWindow &win, const SimulationMetrics &m, sf::Font &font) {
@@ -168,18 +192,204 @@ void updateMetricsWindow(sf::RenderWindow &win, const SimulationMetrics &m, sf::
     std::ostringstream s;
     s << std::fixed << std::setprecision(1)
       << "FPS: " << m.fps << " (" << m.avgFps << " avg)\n"
-      << "Update: " << m.updateMs << " ms\n"
-      << "Frame: " << m.frameMs << " ms\n"
+      << "Update: " << m.updateMs << " ms (" << m.kernel << ")\n"
+      << std::setprecision(2)
+      << "Frame: " << m.frameMs << " ms, sd " << m.frameStdMs << (m.vsync ? " (vsync)\n" : "\n")
+      << std::setprecision(1)
+      << "Dropped: " << m.dropped << " frames\n"
+      << "Steps/s: " << m.stepsPerSec << ", input " << m.inputMs << " ms\n"
       << "Live Cells: " << m.live << "\n"
       << "Δ Cells: " << m.delta << "\n"
-      << "Generation: " << m.gen;
+      << "Generation: " << m.gen << "\n"
+      << "Tile: " << m.tileSize << " cells, " << m.asleep << "/" << m.tiles << " asleep\n"
+      << "Period: " << m.period << "\n"
+      << "Grid: " << m.residentMB << " of " << m.gridMB << " MB resident\n"
+      << "Cold: " << m.coldPages << " pages in " << m.coldMB << " MB";
     sf::Text body(s.str(), font, 16);
     body.setFillColor(sf::Color(180, 220, 255));
     body.setPosition(20, 50);
     win.draw(body);
+
+    // per-worker utilization bars
+    if (!m.workerUtil.empty()) {
+        const float top = 330, avail = 140, barW = 240;
+        float barH = std::max(2.f, avail / m.workerUtil.size() - 2);
+        sf::RectangleShape bg(sf::Vector2f(barW, barH)), bar;
+        bg.setFillColor(sf::Color(50, 50, 70));
+        for (size_t w = 0; w < m.workerUtil.size(); ++w) {
+            float y = top + w * (barH + 2);
+            bg.setPosition(60, y);
+            win.draw(bg);
+            bar.setSize(sf::Vector2f(barW * (float)m.workerUtil[w], barH));
+            bar.setFillColor(LifeAccel::workerColor((int)w));
+            bar.setPosition(60, y);
+            win.draw(bar);
+            if (barH >= 10) {
+                sf::Text label("W" + std::to_string(w), font, (unsigned)std::min(barH, 14.f));
+                label.setFillColor(sf::Color(180, 220, 255));
+                label.setPosition(20, y - 2);
+                win.draw(label);
+            }
+        }
+    }
     win.display();
 }
 
+//
+// ---------- Render Thread ----------
+//
+// After the title screen both windows' GL contexts belong to this thread.
+// The main thread keeps the window events (SFML delivers them to the thread
+// that created the window), steps the board and posts commands here. Each
+// frame copies what it shows out of the board while holding `boardLock`:
+// the cells of the live box, overlay quads, viewport samples and the
+// published metrics. It builds the cell quads from that copy, draws, waits
+// on its pacer or vsync and presents without the lock, so neither vertex
+// building nor a slow swap holds up stepping or input handling. While a
+// frame waits for the lock the main thread yields it between steps.
+//
+// The main thread posts every key press with its timestamp. The time from
+// the oldest pending press to the present of the first frame built after it
+// is the input latency shown in the metrics window.
+//
+enum class RenderCommand { Input, ToggleLoad, ToggleMaps, ToggleVsync, CloseMetrics };
+
+class RenderThread {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // `published` is read under `boardLock`; the viewports belong to this
+    // thread from start() on.
+    RenderThread(sf::RenderWindow &win, sf::RenderWindow &metricsWin, sf::Font &font, const LifeAccel &life,
+                 std::mutex &boardLock, const SimulationMetrics &published, int fps,
+                 Viewport &minimap, std::vector<Viewport> &insets)
+        : win(win), metricsWin(metricsWin), font(font), life(life), boardLock(boardLock),
+          published(published), fps(fps), minimap(minimap), insets(insets) {}
+    ~RenderThread() { stop(); }
+
+    // Neither window may be active on the calling thread.
+    void start(bool vsync) {
+        running = true;
+        thread = std::thread([this, vsync] { run(vsync); });
+    }
+    void stop() {
+        running = false;
+        if (thread.joinable()) thread.join();
+    }
+
+    void post(RenderCommand cmd) {
+        std::lock_guard<std::mutex> lk(cmdLock);
+        commands.push_back({cmd, clock::now()});
+    }
+
+    // True once the thread has let go of the metrics window, so it may close.
+    bool metricsReleased() const { return metricsDone; }
+    // True while a frame is waiting to take `boardLock`.
+    bool wantsBoard() const { return boardWanted; }
+
+private:
+    struct Posted {
+        RenderCommand cmd;
+        clock::time_point issued;
+    };
+
+    sf::RenderWindow &win, &metricsWin;
+    sf::Font &font;
+    const LifeAccel &life;
+    std::mutex &boardLock;
+    const SimulationMetrics &published;
+    int fps;
+    Viewport &minimap;
+    std::vector<Viewport> &insets;
+
+    std::thread thread;
+    std::atomic<bool> running{false}, metricsDone{false}, boardWanted{false};
+    std::mutex cmdLock;
+    std::vector<Posted> commands;
+
+    void run(bool vsync) {
+        FramePacer pacer(vsync ? 0 : fps);
+        win.setVerticalSyncEnabled(vsync);
+        bool showLoad = false, showMaps = true, showMetrics = true;
+        sf::VertexArray cells(sf::Quads), load(sf::Quads);
+        std::vector<uint8_t> snapshot;
+        CellBox snapBox;
+        const int cellSize = life.getCellSize();
+        SimulationMetrics m;
+        double avgFps = 0, inputMs = 0;
+        long long frames = 0;
+        std::vector<Posted> todo;
+
+        while (running) {
+            todo.clear();
+            {
+                std::lock_guard<std::mutex> lk(cmdLock);
+                todo.swap(commands);
+            }
+            for (const Posted &p : todo) switch (p.cmd) {
+                case RenderCommand::Input: break;
+                case RenderCommand::ToggleLoad: showLoad = !showLoad; break;
+                case RenderCommand::ToggleMaps: showMaps = !showMaps; break;
+                case RenderCommand::ToggleVsync:
+                    vsync = !vsync;
+                    win.setVerticalSyncEnabled(vsync);
+                    pacer.setRate(vsync ? 0 : fps);
+                    break;
+                case RenderCommand::CloseMetrics:
+                    if (showMetrics) metricsWin.setActive(false);
+                    showMetrics = false;
+                    metricsDone = true;
+                    break;
+                }
+
+            load.clear();
+            boardWanted = true;
+            {
+                std::lock_guard<std::mutex> lk(boardLock);
+                boardWanted = false;
+                snapBox = life.getBounds();
+                life.copyCells(snapBox, snapshot);
+                if (showLoad) life.appendLoadOverlay(load);
+                if (showMaps) {
+                    for (Viewport &vp : insets) sampleViewport(life, vp);
+                    sampleViewport(life, minimap);
+                }
+                m = published;
+            }
+            cells.clear();
+            appendCells(cells, snapBox, snapshot, cellSize);
+
+            win.clear(sf::Color::Black);
+            win.draw(cells);
+            win.draw(load);
+            if (showMaps) {
+                for (Viewport &vp : insets) drawViewport(win, vp);
+                drawViewport(win, minimap, insets);
+            }
+            pacer.wait();
+            win.display();
+
+            if (!todo.empty()) {
+                auto oldest = todo.front().issued;  // posted in order
+                inputMs = std::chrono::duration<double, std::milli>(clock::now() - oldest).count();
+            }
+            m.frameMs = pacer.lastFrameMs();
+            double meanMs;
+            pacer.frameStats(meanMs, m.frameStdMs);
+            m.dropped = pacer.droppedFrames();
+            m.vsync = vsync;
+            m.fps = 1000.0 / m.frameMs;
+            avgFps = (avgFps * frames + m.fps) / (frames + 1);
+            frames++;
+            m.avgFps = avgFps;
+            m.inputMs = inputMs;
+            if (showMetrics) updateMetricsWindow(metricsWin, m, font);
+        }
+        win.setActive(false);
+        if (showMetrics) metricsWin.setActive(false);
+    }
+};
+
 //
 // ---------- Pixel DNA Renderer ----------
 //
@@ -304,55 +514,512 @@ void showTitleScreen(sf::RenderWindow &win) {
     }
 }
 
+//
+// ---------- Kernel Benchmark ----------
+//
+// Same seeded soup for every built-in kernel; sleeping is defeated by
+// re-seeding before each timed step so every tile is computed.
+void benchmarkKernels(ThreadPool &pool, int w, int h, int cell, int gens = 100) {
+    for (BuiltinKernel k : {BuiltinKernel::Gather, BuiltinKernel::RowSum}) {
+        LifeAccel life(w, h, cell, pool);
+        life.setBuiltinKernel(k);
+        std::mt19937 rng(1);
+        double total = 0;
+        for (int g = 0; g < gens; ++g) {
+            life.randomize(0.3, rng);
+            life.updateParallel();
+            total += life.getStepMs();
+        }
+        std::cout << std::left << std::setw(16) << life.kernelName()
+                  << std::fixed << std::setprecision(3) << total / gens << " ms/gen ("
+                  << life.getCols() << "x" << life.getRows() << ")\n";
+    }
+}
+
+// Sparse but structured: gliders in far-apart lanes plus long rows of
+// blinkers, the case the interval engine is meant for.
+void benchmarkIntervalEngine(ThreadPool &pool, int n = 8192, int gens = 50) {
+    LifeAccel dense(n, n, 1, pool);
+    std::mt19937 rng(3);
+    for (int g = 0; g < 200; ++g) {
+        int r = 8 + rng() % (n - 16), c = 8 + rng() % (n - 16);
+        for (auto p : {std::pair<int, int>{0, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}})
+            dense.set(r + p.first, c + p.second, true);
+    }
+    for (int r = 256; r < n; r += 512)
+        for (int c = 16; c + 3 < n - 16; c += 4)
+            for (int k = 0; k < 3; ++k) dense.set(r, c + k, true);
+    IntervalLife runs = IntervalLife::fromDense(dense, pool);
+
+    auto time = [](auto &&fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+    double denseMs = time([&] { for (int g = 0; g < gens; ++g) dense.updateParallel(); });
+    double runMs = time([&] { for (int g = 0; g < gens; ++g) runs.step(); });
+    bool same = runs.getLiveCount() == dense.getLiveCount();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "dense           " << denseMs / gens << " ms/gen (" << n << "x" << n << ")\n"
+              << "interval        " << runMs / gens << " ms/gen (" << runs.runCount() << " runs)"
+              << (same ? "\n" : "  MISMATCH\n");
+}
+
+// A few thousand gliders scattered over the whole 2^32 x 2^32 universe.
+void benchmarkSparseEngine(ThreadPool &pool, int gliders = 3000, int gens = 200) {
+    SparseLife life(pool);
+    std::mt19937 rng(5);
+    for (int g = 0; g < gliders; ++g) {
+        uint32_t x = rng(), y = rng();
+        for (auto p : {std::pair<int, int>{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}})
+            life.add(x + p.first, y + p.second);
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    for (int g = 0; g < gens; ++g) life.step();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / gens;
+    std::cout << std::fixed << std::setprecision(3)
+              << "sparse          " << ms << " ms/gen (" << life.getLiveCount() << " cells, "
+              << std::setprecision(1) << life.getLiveCount() / ms / 1000 << " Mcells/s)\n";
+}
+
+// Parallel wires three rows apart, each carrying a pulse every 32 cells: the
+// signal count is a small fraction of the copper. The dense reference scans
+// every cell, as a byte-grid step would.
+void benchmarkWireworld(ThreadPool &pool, int rows = 4096, int cols = 8192, int gens = 50) {
+    WireWorld ww(cols, rows, pool);
+    std::vector<uint8_t> dense((size_t)rows * cols, kWireEmpty), out(dense.size());
+    for (int r = 1; r < rows; r += 3)
+        for (int c = 0; c < cols; ++c) {
+            uint8_t s = c % 32 == 1 ? kWireHead : c % 32 == 0 ? kWireTail : kWireCopper;
+            ww.set(r, c, s);
+            dense[(size_t)r * cols + c] = s;
+        }
+
+    auto time = [](auto &&fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+    const int denseGens = 5;
+    double denseMs = time([&] {
+        for (int g = 0; g < denseGens; ++g) {
+            for (int i = 0; i < rows; ++i)
+                for (int j = 0; j < cols; ++j) {
+                    uint8_t s = dense[(size_t)i * cols + j], v = s;
+                    if (s == kWireHead) v = kWireTail;
+                    else if (s == kWireTail) v = kWireCopper;
+                    else if (s == kWireCopper) {
+                        int n = 0;
+                        for (int di = std::max(0, i - 1); di <= std::min(rows - 1, i + 1); ++di)
+                            for (int dj = std::max(0, j - 1); dj <= std::min(cols - 1, j + 1); ++dj)
+                                n += dense[(size_t)di * cols + dj] == kWireHead;
+                        if (n == 1 || n == 2) v = kWireHead;
+                    }
+                    out[(size_t)i * cols + j] = v;
+                }
+            dense.swap(out);
+        }
+    });
+    size_t copper = ww.getConductorCount(), heads = ww.getHeadCount();
+    for (int g = 0; g < denseGens; ++g) ww.step();
+    bool same = std::equal(dense.begin(), dense.end(), ww.data());
+    double listMs = time([&] { for (int g = 0; g < gens; ++g) ww.step(); });
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "wireworld dense " << denseMs / denseGens << " ms/gen (" << cols << "x" << rows << ")\n"
+              << "wireworld lists " << listMs / gens << " ms/gen (" << heads << " heads on " << copper
+              << " copper)" << (same ? "\n" : "  MISMATCH\n");
+}
+
+// One Lenia step by FFT against the same step by direct summation over the
+// kernel, at two radii: the FFT cost should not move with the radius.
+void benchmarkContinuous(ThreadPool &pool, int n = 512) {
+    for (float radius : {13.f, 52.f}) {
+        ContinuousParams p;
+        p.radius = radius;
+        ContinuousLife fft(n, n, pool, p);
+        std::mt19937 rng(3);
+        fft.seed(rng, 40);
+        std::vector<float> a(fft.data(), fft.data() + (size_t)n * n), u(a.size());
+
+        // the ring kernel, as the engine builds it
+        struct Tap {
+            int dy, dx;
+            float w;
+        };
+        std::vector<Tap> taps;
+        const int reach = (int)std::ceil(radius) + 1;
+        double sum = 0;
+        for (int dy = -reach; dy <= reach; ++dy)
+            for (int dx = -reach; dx <= reach; ++dx) {
+                float r = std::sqrt((float)(dy * dy + dx * dx)) / radius;
+                float v = r > 0 && r < 1 ? std::exp(4 - 1 / (r * (1 - r))) : 0.f;
+                if (v > 0) {
+                    taps.push_back({dy, dx, v});
+                    sum += v;
+                }
+            }
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < n; ++r)
+            for (int c = 0; c < n; ++c) {
+                double s = 0;
+                for (const Tap &t : taps) s += t.w * a[(size_t)((r + t.dy) & (n - 1)) * n + ((c + t.dx) & (n - 1))];
+                u[(size_t)r * n + c] = (float)(s / sum);
+            }
+        const float g = -1 / (2 * p.sigma * p.sigma);
+        for (size_t i = 0; i < a.size(); ++i) {
+            float d = u[i] - p.mu;
+            a[i] = std::clamp(a[i] + p.dt * (2 * std::exp(d * d * g) - 1), 0.f, 1.f);
+        }
+        double directMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        fft.step();
+        float err = 0;
+        for (size_t i = 0; i < a.size(); ++i) err = std::max(err, std::fabs(a[i] - fft.data()[i]));
+        double fftMs = 0;
+        for (int k = 0; k < 5; ++k) {
+            fft.step();
+            fftMs += fft.getStepMs() / 5;
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << "lenia direct    " << directMs << " ms/gen (" << n << "x" << n << ", radius " << (int)radius << ", "
+                  << taps.size() << " taps)\n"
+                  << "lenia fft       " << fftMs << " ms/gen" << (err < 1e-3f ? "\n" : "  MISMATCH\n");
+    }
+}
+
+//
+// ---------- Wireworld Mode ----------
+//
+// --wireworld <file.rle>: runs a Golly Wireworld RLE in the main window in
+// place of Life. Copper is drawn once into its own vertex array, and each
+// frame only rebuilds the signals. Space pauses.
+//
+void runWireworld(sf::RenderWindow &win, const std::string &path, ThreadPool &pool, sf::Font &font, int fps) {
+    std::ifstream in(path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> states;
+    uint32_t pr, pc;
+    std::string err;
+    if (!in || !parseWireworldRle(text, states, pr, pc, &err)) {
+        std::cerr << path << ": " << (in ? err : "cannot read") << "\n";
+        return;
+    }
+    const int rows = std::max<int>(64, pr + 16), cols = std::max<int>(64, pc + 16);
+    WireWorld ww(cols, rows, pool);
+    ww.stamp(states, pr, pc, (rows - (int)pr) / 2, (cols - (int)pc) / 2);
+    const float cell = std::min((float)win.getSize().x / cols, (float)win.getSize().y / rows);
+
+    sf::VertexArray copper(sf::Quads), signals(sf::Quads);
+    ww.appendCopper(copper, cell);
+    sf::Text status("", font, 16);
+    status.setFillColor(sf::Color(180, 220, 255));
+    status.setPosition(10, 10);
+    FramePacer pacer(fps);
+    bool paused = false;
+    while (win.isOpen()) {
+        sf::Event e;
+        while (win.pollEvent(e)) {
+            if (e.type == sf::Event::Closed) win.close();
+            if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::Space) paused = !paused;
+        }
+        if (!paused) ww.step();
+
+        signals.clear();
+        ww.appendSignals(signals, cell);
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(3) << "Gen " << ww.getGeneration() << "  heads "
+          << ww.getHeadCount() << "  " << ww.getStepMs() << " ms" << (paused ? "  (paused)" : "");
+        status.setString(s.str());
+
+        win.clear(sf::Color::Black);
+        win.draw(copper);
+        win.draw(signals);
+        win.draw(status);
+        pacer.wait();
+        win.display();
+    }
+}
+
+//
+// ---------- Continuous Mode ----------
+//
+// --lenia / --smoothlife: runs the continuous engine in the main window in
+// place of Life. The board is half the window each way and goes to the
+// screen through one streaming texture, like the viewports. Space pauses,
+// R reseeds.
+//
+void runContinuous(sf::RenderWindow &win, ContinuousRule rule, ThreadPool &pool, sf::Font &font, int fps) {
+    ContinuousParams params;
+    params.rule = rule;
+    if (rule == ContinuousRule::SmoothLife) params.radius = 12;
+    ContinuousLife life(win.getSize().x / 2, win.getSize().y / 2, pool, params);
+    const int cols = life.getCols(), rows = life.getRows();
+    std::mt19937 rng(std::random_device{}());
+    life.seed(rng, rule == ContinuousRule::Lenia ? 24 : 200);
+
+    sf::Texture tex;
+    tex.create(cols, rows);
+    std::vector<sf::Uint8> rgba((size_t)cols * rows * 4);
+    const float scale = std::min((float)win.getSize().x / cols, (float)win.getSize().y / rows);
+    sf::Sprite sprite(tex);
+    sprite.setScale(scale, scale);
+    sprite.setPosition((win.getSize().x - cols * scale) / 2, (win.getSize().y - rows * scale) / 2);
+    sf::Text status("", font, 16);
+    status.setFillColor(sf::Color(180, 220, 255));
+    status.setPosition(10, 10);
+    FramePacer pacer(fps);
+    bool paused = false;
+    while (win.isOpen()) {
+        sf::Event e;
+        while (win.pollEvent(e)) {
+            if (e.type == sf::Event::Closed) win.close();
+            if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::Space) paused = !paused;
+            if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::R)
+                life.seed(rng, rule == ContinuousRule::Lenia ? 24 : 200);
+        }
+        if (!paused) life.step();
+
+        const float *a = life.data();
+        for (size_t i = 0; i < (size_t)cols * rows; ++i) {
+            float d = a[i];
+            sf::Uint8 *p = &rgba[i * 4];
+            p[0] = (sf::Uint8)(12 + 68 * d);
+            p[1] = (sf::Uint8)(12 + 188 * d);
+            p[2] = (sf::Uint8)(24 + 231 * d);
+            p[3] = 255;
+        }
+        tex.update(rgba.data());
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(3) << (rule == ContinuousRule::Lenia ? "Lenia" : "SmoothLife")
+          << "  Gen " << life.getGeneration() << "  mass " << std::setprecision(0) << life.mass() << "  "
+          << std::setprecision(3) << life.getStepMs() << " ms" << (paused ? "  (paused)" : "");
+        status.setString(s.str());
+
+        win.clear(sf::Color::Black);
+        win.draw(sprite);
+        win.draw(status);
+        pacer.wait();
+        win.display();
+    }
+}
+
 //
 // ---------- Main ----------
 //
-int main() {
+int main(int argc, char **argv) {
     constexpr int W = 1280, H = 720, CELL = 4, FPS = 60;
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]) == "--bench") {
+            ThreadPool pool;
+            benchmarkKernels(pool, W, H, CELL);
+            benchmarkKernels(pool, 4096, 4096, 1, 20);
+            benchmarkIntervalEngine(pool);
+            benchmarkSparseEngine(pool);
+            benchmarkWireworld(pool);
+            benchmarkContinuous(pool);
+            return 0;
+        }
+
     sf::RenderWindow win(sf::VideoMode(W, H), "LifeAccel — Conway's Game of Life");
-    win.setFramerateLimit(FPS);
+    win.setFramerateLimit(FPS);  // title screen only; the simulation is paced below
 
-    sf::RenderWindow metrics(sf::VideoMode(320, 240), "Metrics Dashboard");
+    // frames are paced by the render thread, or by the display with --vsync / V
+    bool vsync = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]) == "--vsync") vsync = true;
+
+    sf::RenderWindow metrics(sf::VideoMode(320, 480), "Metrics Dashboard");
     metrics.setPosition({1320, 100});
 
     showTitleScreen(win);
+    win.setFramerateLimit(0);
 
     ThreadPool pool;
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--wireworld") {
+            metrics.close();
+            sf::Font font;
+            font.loadFromFile("ARIAL.ttf");
+            runWireworld(win, argv[i + 1], pool, font, FPS);
+            return 0;
+        }
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]) == "--lenia" || std::string(argv[i]) == "--smoothlife") {
+            metrics.close();
+            sf::Font font;
+            font.loadFromFile("ARIAL.ttf");
+            runContinuous(win, argv[i][2] == 'l' ? ContinuousRule::Lenia : ContinuousRule::SmoothLife, pool, font, FPS);
+            return 0;
+        }
     LifeAccel life(W, H, CELL, pool);
     life.randomize(0.3);
 
+    // --kernel <plugin>: validated, benchmarked and kept only if faster
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--kernel") {
+            KernelReport r = life.loadKernelPlugin(argv[++i]);
+            if (!r.valid) {
+                std::cerr << "Kernel rejected: " << r.error << "\n";
+                continue;
+            }
+            std::cout << "Kernel " << r.name << ": " << r.pluginMs << " ms/gen vs "
+                      << r.baselineMs << " ms/gen" << (r.selected ? " (selected)\n" : "\n");
+        }
+
+    // --pattern <file.rle|file.mc>: start from a pattern, centred, instead of
+    // a soup; parsed patterns are cached in $LIFE_PATTERN_CACHE
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--pattern") {
+            const char *dir = std::getenv("LIFE_PATTERN_CACHE");
+            PatternStore store(dir ? dir : "pattern-cache");
+            MappedSnapshot pat;
+            std::string err;
+            if (!store.load(argv[++i], pat, &err)) {
+                std::cerr << "Pattern not loaded: " << err << "\n";
+                continue;
+            }
+            uint8_t *cells = life.cells();
+            std::fill(cells, cells + (size_t)life.getRows() * life.getCols(), 0);
+            stampPattern(life, pat, (life.getRows() - (int)pat.header().rows) / 2,
+                         (life.getCols() - (int)pat.header().cols) / 2);
+        }
+
     sf::Font font;
     font.loadFromFile("ARIAL.ttf");
 
+    // minimap in the bottom-right corner; --viewport x,y,w,h (board cells)
+    // adds an inset down the left edge, as many times as given. M toggles both.
+    Viewport minimap;
+    {
+        float mw = 200, mh = std::max(20.f, mw * life.getRows() / life.getCols());
+        initViewport(minimap, {0, 0, life.getRows() - 1, life.getCols() - 1}, {W - mw - 10, H - mh - 10, mw, mh});
+    }
+    std::vector<Viewport> insets;
+    float insetY = 10;
+    for (int i = 1; i + 1 < argc; ++i) {
+        int x, y, w, h;
+        if (std::string(argv[i]) != "--viewport" || std::sscanf(argv[++i], "%d,%d,%d,%d", &x, &y, &w, &h) != 4 ||
+            w <= 0 || h <= 0)
+            continue;
+        float iw = 200, ih = std::min(300.f, iw * h / w);
+        insets.emplace_back();
+        initViewport(insets.back(), {y, x, y + h - 1, x + w - 1}, {10, insetY, iw, ih});
+        insetY += ih + 10;
+    }
+
     SimulationMetrics m;
     int prevLive = 0;
-    sf::Clock frame, update;
+    PeriodDetector period;
 
-    while (win.isOpen()) {
-        sf::Event e;
-        while (win.pollEvent(e))
-            if (e.type == sf::Event::Closed) win.close();
-        while (metrics.pollEvent(e))
-            if (e.type == sf::Event::Closed) metrics.close();
+    // --checkpoint <dir>: resume from the directory if it holds a chain, then
+    // keep checkpointing into it every couple of minutes and on C
+    Checkpointer ckpt;
+    sf::Clock sinceCheckpoint;
+    std::string ckptDir;
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--checkpoint") ckptDir = argv[++i];
+    if (!ckptDir.empty()) {
+        std::string err;
+        if (Checkpointer::restore(ckptDir, life, &m.gen, &err))
+            std::cout << "Resumed " << ckptDir << " at generation " << m.gen << "\n";
+        if (!ckpt.open(ckptDir, life.getRows(), life.getCols(), &err)) {
+            std::cerr << "Checkpoints disabled: " << err << "\n";
+            ckptDir.clear();
+        }
+    }
+    auto checkpoint = [&]() {
+        std::string err;
+        if (!ckpt.checkpoint(life, m.gen, &err)) std::cerr << "Checkpoint failed: " << err << "\n";
+        sinceCheckpoint.restart();
+    };
 
-        update.restart();
-        life.updateParallel();
-        m.updateMs = update.getElapsedTime().asMilliseconds();
+    // The board is stepped here; the render thread reads it under boardLock,
+    // and everything below that touches `life` or `m` holds it. --sps sets
+    // generations per second. It defaults to the frame rate, so every
+    // generation reaches the screen; at --sps 0 stepping is unpaced and
+    // frames show the newest generation. Until a step is due, window events
+    // are polled every millisecond, so a key press never waits out the step
+    // period.
+    int sps = FPS;
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--sps") sps = std::max(0, std::atoi(argv[++i]));
+    std::mutex boardLock;
+    win.setActive(false);
+    metrics.setActive(false);
+    RenderThread render(win, metrics, font, life, boardLock, m, FPS, minimap, insets);
+    render.start(vsync);
+    FramePacer stepPacer(sps);
 
-        win.clear(sf::Color::Black);
-        life.draw(win);
-        win.display();
+    bool running = win.isOpen();
+    while (running) {
+        sf::Event e;
+        while (win.pollEvent(e)) {
+            if (e.type == sf::Event::Closed) running = false;
+            if (e.type == sf::Event::KeyPressed) {
+                // O: load-balance overlay, [ / ]: shrink / grow tiles, S: snapshot, R: RLE,
+                // K: switch built-in kernel, C: checkpoint now (with --checkpoint),
+                // V: toggle vsync, M: minimap and viewports
+                std::lock_guard<std::mutex> lk(boardLock);
+                RenderCommand cmd = RenderCommand::Input;
+                if (e.key.code == sf::Keyboard::O) cmd = RenderCommand::ToggleLoad;
+                if (e.key.code == sf::Keyboard::K)
+                    life.setBuiltinKernel(life.getBuiltinKernel() == BuiltinKernel::RowSum
+                                              ? BuiltinKernel::Gather : BuiltinKernel::RowSum);
+                if (e.key.code == sf::Keyboard::S) {
+                    std::string path = "gen_" + std::to_string(m.gen) + ".snap";
+                    if (!life.saveSnapshot(path)) std::cerr << "Could not write " << path << "\n";
+                }
+                if (e.key.code == sf::Keyboard::V) cmd = RenderCommand::ToggleVsync;
+                if (e.key.code == sf::Keyboard::M) cmd = RenderCommand::ToggleMaps;
+                if (e.key.code == sf::Keyboard::R) {
+                    std::string path = "gen_" + std::to_string(m.gen) + ".rle";
+                    std::ofstream out(path, std::ios::binary);
+                    if (!out || !writeRle(out, pool, life)) std::cerr << "Could not write " << path << "\n";
+                }
+                if (e.key.code == sf::Keyboard::C && !ckptDir.empty()) checkpoint();
+                if (e.key.code == sf::Keyboard::LBracket) life.setTileSize(life.getTileSize() / 2);
+                if (e.key.code == sf::Keyboard::RBracket) life.setTileSize(std::min(256, life.getTileSize() * 2));
+                render.post(cmd);
+            }
+        }
+        while (metrics.isOpen() && metrics.pollEvent(e))
+            if (e.type == sf::Event::Closed) render.post(RenderCommand::CloseMetrics);
+        if (metrics.isOpen() && render.metricsReleased()) metrics.close();
+        if (!stepPacer.due()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        stepPacer.wait();
 
-        m.frameMs = frame.restart().asMilliseconds();
-        m.fps = 1000.0 / m.frameMs;
-        m.avgFps = (m.avgFps * m.gen + m.fps) / (m.gen + 1);
-        m.live = life.getLiveCount();
-        m.delta = m.live - prevLive;
-        m.gen++;
-        prevLive = m.live;
+        {
+            std::lock_guard<std::mutex> lk(boardLock);
+            life.updateParallel();
+            m.updateMs = life.getStepMs();
 
-        if (metrics.isOpen())
-            updateMetricsWindow(metrics, m, font);
+            double stepMs, stepSd;
+            stepPacer.frameStats(stepMs, stepSd);
+            m.stepsPerSec = stepMs > 0 ? 1000.0 / stepMs : 0;
+            m.live = life.getLiveCount();
+            m.delta = m.live - prevLive;
+            m.gen++;
+            m.tileSize = life.getTileSize();
+            m.asleep = life.getSleepingTiles();
+            m.kernel = life.kernelName();
+            m.gridMB = life.getGridBytes() / 1048576.0;
+            m.residentMB = life.getResidentGridBytes() / 1048576.0;
+            m.coldPages = life.getColdPages();
+            m.coldMB = life.getColdBytes() / 1048576.0;
+            m.tiles = life.getTileCount();
+            m.workerUtil = life.workerUtilization();
+            period.observe(life, m.gen);
+            m.period = period.describe();
+            prevLive = m.live;
+            if (!ckptDir.empty() && sinceCheckpoint.getElapsedTime().asSeconds() > 120) checkpoint();
+        }
+        while (render.wantsBoard()) std::this_thread::yield();
     }
+    render.stop();
     return 0;
 }
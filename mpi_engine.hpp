@@ -0,0 +1,260 @@
+#pragma once
+#include "life_accel.hpp"
+// the C API only; keeps mpi.h from pulling in the removed C++ bindings
+#ifndef OMPI_SKIP_MPICXX
+#define OMPI_SKIP_MPICXX 1
+#endif
+#ifndef MPICH_SKIP_MPICXX
+#define MPICH_SKIP_MPICXX 1
+#endif
+#include <mpi.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// ---------- MPI Engine ----------
+//
+// Splits a rows x cols B3/S23 board into a 2D grid of blocks, one per rank,
+// over a non-periodic Cartesian communicator. Each rank keeps its block plus
+// a one-cell halo ring in a byte grid. It steps the block with
+// stepBandRowSum, the band kernel LifeAccel runs. A generation:
+//   1. post receives for the halo from all eight neighbours, then send the
+//      block's edge rows, edge columns and corners, all non-blocking;
+//   2. step the interior, which reads no halo, on the local ThreadPool while
+//      the calling thread drives MPI progress;
+//   3. unpack the halo and step the one-cell rim of the block.
+// Board edges have no neighbour (MPI_PROC_NULL), so their halo stays dead.
+//
+// Block columns are cut on 64-cell boundaries. Each rank then owns whole
+// words of every snapshot row it holds, and ranks write snapshots in
+// parallel with MPI-IO.
+//
+// Only the calling thread makes MPI calls, so MPI_THREAD_FUNNELED suffices.
+//
+inline uint64_t mixCell(uint64_t r, uint64_t c) {
+    uint64_t x = r * 0x9e3779b97f4a7c15ull ^ (c + 0x632be59bd9b4e019ull);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+class MpiLife {
+public:
+    MpiLife(MPI_Comm comm, ThreadPool &pool) : world(comm), pool(pool) {}
+    MpiLife(const MpiLife &) = delete;
+    MpiLife &operator=(const MpiLife &) = delete;
+    ~MpiLife() {
+        if (cart != MPI_COMM_NULL) MPI_Comm_free(&cart);
+    }
+
+    // Collective. Picks the process grid with the least halo per block.
+    bool open(int boardRows, int boardCols, std::string *error = nullptr) {
+        rows = boardRows;
+        cols = boardCols;
+        wordsPerRow = (cols + 63) / 64;
+        int size;
+        MPI_Comm_size(world, &size);
+        double best = -1;
+        for (int p = 1; p <= size; ++p) {
+            if (size % p) continue;
+            int q = size / p;
+            if (p > rows || (size_t)q > wordsPerRow) continue;
+            double halo = (double)rows / p + (double)cols / q;
+            if (best < 0 || halo < best) {
+                best = halo;
+                dims[0] = p;
+                dims[1] = q;
+            }
+        }
+        if (best < 0) {
+            if (error) *error = std::to_string(size) + " ranks cannot tile a " + std::to_string(cols) + "x" +
+                                std::to_string(rows) + " board (a block needs a row and 64 columns)";
+            return false;
+        }
+        int periods[2] = {0, 0};
+        MPI_Cart_create(world, 2, dims, periods, 1, &cart);
+        MPI_Comm_rank(cart, &rank);
+        MPI_Cart_coords(cart, rank, 2, coords);
+
+        top = (int)((long long)rows * coords[0] / dims[0]);
+        h = (int)((long long)rows * (coords[0] + 1) / dims[0]) - top;
+        word0 = wordsPerRow * coords[1] / dims[1];
+        size_t word1 = wordsPerRow * (coords[1] + 1) / dims[1];
+        left = (int)(word0 * 64);
+        w = std::min(cols, (int)(word1 * 64)) - left;
+        stride = w + 2;
+        cur.assign((size_t)(h + 2) * stride, 0);
+        next.assign(cur.size(), 0);
+        zero.assign(stride, 0);
+
+        for (int d = 0; d < 9; ++d) {
+            if (d == 4) continue;
+            int dy = d / 3 - 1, dx = d % 3 - 1;
+            int nc[2] = {coords[0] + dy, coords[1] + dx};
+            neighbour[d] = MPI_PROC_NULL;
+            if (nc[0] >= 0 && nc[0] < dims[0] && nc[1] >= 0 && nc[1] < dims[1])
+                MPI_Cart_rank(cart, nc, &neighbour[d]);
+            size_t n = (size_t)(dy ? 1 : h) * (dx ? 1 : w);
+            sendBuf[d].assign(n, 0);
+            recvBuf[d].assign(n, 0);  // stays zero from MPI_PROC_NULL: the dead outside
+        }
+        return true;
+    }
+
+    int getRank() const { return rank; }
+    int getTop() const { return top; }
+    int getLeft() const { return left; }
+    int getHeight() const { return h; }
+    int getWidth() const { return w; }
+    void getProcessGrid(int &p, int &q) const {
+        p = dims[0];
+        q = dims[1];
+    }
+
+    // Sets every cell of the block from alive(row, col), in board coordinates.
+    template <class Fn>
+    void fill(Fn alive) {
+        for (int i = 0; i < h; ++i)
+            for (int j = 0; j < w; ++j) cur[(size_t)(i + 1) * stride + j + 1] = alive(top + i, left + j) ? 1 : 0;
+    }
+
+    void step() {
+        auto t0 = std::chrono::steady_clock::now();
+        MPI_Request req[16];
+        for (int d = 0, k = 0; d < 9; ++d) {
+            if (d == 4) continue;
+            // a neighbour's message towards us travels in the opposite direction, 8 - d
+            MPI_Irecv(recvBuf[d].data(), (int)recvBuf[d].size(), MPI_BYTE, neighbour[d], 8 - d, cart, &req[k++]);
+        }
+        for (int d = 0, k = 8; d < 9; ++d) {
+            if (d == 4) continue;
+            copyRect(d, false);
+            MPI_Isend(sendBuf[d].data(), (int)sendBuf[d].size(), MPI_BYTE, neighbour[d], d, cart, &req[k++]);
+        }
+
+        // interior: rows and columns 2 .. h-1 / w-1 of the padded grid
+        const int bands = std::max<int>(1, (int)pool.size() * 4);
+        const int irows = std::max(0, h - 2);
+        for (int b = 0; b < bands && w > 2; ++b) {
+            int i0 = 2 + irows * b / bands, i1 = 2 + irows * (b + 1) / bands;
+            if (i0 < i1) pool.enqueue([=] { stepRect(i0, i1, 2, w); });
+        }
+        int done = 0;
+        while (!done) {
+            MPI_Testall(16, req, &done, MPI_STATUSES_IGNORE);
+            if (!done) std::this_thread::yield();
+        }
+        haloMs = msSince(t0);
+
+        for (int d = 0; d < 9; ++d)
+            if (d != 4) copyRect(d, true);
+        // rim: first and last block rows, then first and last columns between them
+        pool.enqueue([=] { stepRect(1, 2, 1, w + 1); });
+        if (h > 1) pool.enqueue([=] { stepRect(h, h + 1, 1, w + 1); });
+        if (h > 2) {
+            pool.enqueue([=] { stepRect(2, h, 1, 2); });
+            if (w > 1) pool.enqueue([=] { stepRect(2, h, w, w + 1); });
+        }
+        pool.waitAll();
+        cur.swap(next);
+        stepMs = msSince(t0);
+    }
+
+    // Collective: live cells on the whole board.
+    long long population() const {
+        long long local = 0, total = 0;
+        for (int i = 1; i <= h; ++i)
+            for (int j = 1; j <= w; ++j) local += cur[(size_t)i * stride + j];
+        MPI_Allreduce(&local, &total, 1, MPI_LONG_LONG, MPI_SUM, cart);
+        return total;
+    }
+
+    // Collective: order-independent hash of the live cells' board coordinates,
+    // equal for equal boards however they are split.
+    uint64_t fingerprint() const {
+        uint64_t local = 0, total = 0;
+        for (int i = 1; i <= h; ++i)
+            for (int j = 1; j <= w; ++j)
+                if (cur[(size_t)i * stride + j]) local += mixCell(top + i - 1, left + j - 1);
+        MPI_Allreduce(&local, &total, 1, MPI_UINT64_T, MPI_SUM, cart);
+        return total;
+    }
+
+    // Collective: writes the board as a snapshot, every rank its own words.
+    bool saveSnapshot(const std::string &path, std::string *error = nullptr) const {
+        MPI_File f;
+        int ok = MPI_File_open(cart, path.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &f) ==
+                 MPI_SUCCESS;
+        if (ok) {
+            // an older, longer file at `path` would otherwise keep its tail
+            MPI_Offset bytes = sizeof(SnapshotHeader) + (MPI_Offset)rows * wordsPerRow * 8;
+            ok &= MPI_File_set_size(f, bytes) == MPI_SUCCESS;
+            if (rank == 0) {
+                SnapshotHeader hdr = makeSnapshotHeader(rows, cols);
+                ok &= MPI_File_write_at(f, 0, &hdr, sizeof hdr, MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+            }
+            std::vector<uint64_t> words((w + 63) / 64);
+            for (int i = 0; i < h && ok; ++i) {
+                std::fill(words.begin(), words.end(), 0);
+                const uint8_t *row = &cur[(size_t)(i + 1) * stride + 1];
+                for (int j = 0; j < w; ++j) words[j >> 6] |= (uint64_t)row[j] << (j & 63);
+                MPI_Offset at = sizeof(SnapshotHeader) + ((MPI_Offset)(top + i) * wordsPerRow + word0) * 8;
+                ok &= MPI_File_write_at(f, at, words.data(), (int)words.size() * 8, MPI_BYTE,
+                                        MPI_STATUS_IGNORE) == MPI_SUCCESS;
+            }
+            MPI_File_close(&f);
+        }
+        int all = 0;
+        MPI_Allreduce(&ok, &all, 1, MPI_INT, MPI_LAND, cart);
+        if (!all && error) *error = "cannot write " + path;
+        return all != 0;
+    }
+
+    // Last step: total time, and time until the halo had arrived.
+    double getStepMs() const { return stepMs; }
+    double getHaloMs() const { return haloMs; }
+
+private:
+    MPI_Comm world, cart = MPI_COMM_NULL;
+    ThreadPool &pool;
+    int rows = 0, cols = 0, rank = 0;
+    size_t wordsPerRow = 0, word0 = 0;
+    int dims[2] = {1, 1}, coords[2] = {0, 0};
+    int top = 0, left = 0, h = 0, w = 0, stride = 0;  // block in board cells; padded row length
+    std::vector<uint8_t> cur, next, zero;
+    int neighbour[9];  // by direction (dy + 1) * 3 + (dx + 1); 4 is this rank
+    std::vector<uint8_t> sendBuf[9], recvBuf[9];
+    double stepMs = 0, haloMs = 0;
+
+    static double msSince(std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void stepRect(int i0, int i1, int j0, int j1) {
+        stepBandRowSum(cur.data(), next.data(), h + 2, stride, i0, i1, j0, j1, zero.data());
+    }
+
+    // Packs the block's edge facing direction d into sendBuf[d], or unpacks
+    // recvBuf[d] into the halo on that side.
+    void copyRect(int d, bool unpack) {
+        int dy = d / 3 - 1, dx = d % 3 - 1;
+        int nr = dy ? 1 : h, nc = dx ? 1 : w;
+        int r0 = dy < 0 ? 1 : dy > 0 ? h : 1, c0 = dx < 0 ? 1 : dx > 0 ? w : 1;
+        if (unpack) {
+            r0 += dy;
+            c0 += dx;
+        }
+        uint8_t *buf = unpack ? recvBuf[d].data() : sendBuf[d].data();
+        for (int i = 0; i < nr; ++i) {
+            uint8_t *g = &cur[(size_t)(r0 + i) * stride + c0];
+            if (unpack) std::copy_n(buf + (size_t)i * nc, nc, g);
+            else std::copy_n(g, nc, buf + (size_t)i * nc);
+        }
+    }
+};
@@ -0,0 +1,230 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//
+// ---------- Page Memory ----------
+//
+// Large grids are mapped straight from the OS. Fresh pages read as the
+// kernel's shared zero page until first written, and pages handed back with
+// pageDiscard() return to that state, so an all-dead region costs no
+// resident memory however large the board is.
+//
+inline size_t pageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwPageSize;
+#else
+    static const size_t sz = (size_t)sysconf(_SC_PAGESIZE);
+    return sz;
+#endif
+}
+
+// Allocations at least this large come from pageAlloc, smaller ones from calloc.
+constexpr size_t kPageAllocThreshold = 1 << 20;
+
+inline void *pageAlloc(size_t n) {
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, n, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void *p = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+#endif
+}
+
+inline void pageFree(void *p, size_t n) {
+#ifdef _WIN32
+    (void)n;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, n);
+#endif
+}
+
+// Drops the whole pages inside [p, p + n); they read as zero afterwards.
+// Returns the number of bytes dropped.
+inline size_t pageDiscard(void *p, size_t n) {
+    const size_t ps = pageSize();
+    uintptr_t b = ((uintptr_t)p + ps - 1) & ~(uintptr_t)(ps - 1);
+    uintptr_t e = ((uintptr_t)p + n) & ~(uintptr_t)(ps - 1);
+    if (e <= b) return 0;
+#ifdef _WIN32
+    VirtualFree((void *)b, e - b, MEM_DECOMMIT);
+    VirtualAlloc((void *)b, e - b, MEM_COMMIT, PAGE_READWRITE);
+#else
+    madvise((void *)b, e - b, MADV_DONTNEED);
+#endif
+    return e - b;
+}
+
+// Bytes of [p, p + n) currently backed by physical memory.
+inline size_t pageResident(const void *p, size_t n) {
+#ifdef _WIN32
+    // QueryWorkingSetEx reports each page's Valid bit. It lives in kernel32
+    // as K32QueryWorkingSetEx since Windows 7, so no psapi import is needed.
+    struct WorkingSetInfo {
+        void *addr;
+        ULONG_PTR attributes;  // bit 0: page is in the working set
+    };
+    using QueryFn = BOOL(WINAPI *)(HANDLE, void *, DWORD);
+    static const QueryFn query =
+        (QueryFn)(void *)GetProcAddress(GetModuleHandleA("kernel32.dll"), "K32QueryWorkingSetEx");
+    if (!query) return n;
+    const size_t ps = pageSize();
+    uintptr_t b = (uintptr_t)p & ~(uintptr_t)(ps - 1);
+    size_t pages = ((uintptr_t)p + n - b + ps - 1) / ps, resident = 0;
+    std::vector<WorkingSetInfo> info(std::min<size_t>(pages, 65536));
+    for (size_t done = 0; done < pages; done += info.size()) {
+        size_t k = std::min(info.size(), pages - done);
+        for (size_t i = 0; i < k; ++i) info[i] = {(void *)(b + (done + i) * ps), 0};
+        if (!query(GetCurrentProcess(), info.data(), (DWORD)(k * sizeof(WorkingSetInfo)))) return n;
+        for (size_t i = 0; i < k; ++i) resident += info[i].attributes & 1;
+    }
+    return std::min(n, resident * ps);
+#else
+    const size_t ps = pageSize();
+    uintptr_t b = (uintptr_t)p & ~(uintptr_t)(ps - 1);
+    size_t pages = ((uintptr_t)p + n - b + ps - 1) / ps;
+    std::vector<unsigned char> vec(pages);
+    if (mincore((void *)b, pages * ps, vec.data()) != 0) return n;
+    size_t resident = 0;
+    for (unsigned char v : vec) resident += v & 1;
+    return std::min(n, resident * ps);
+#endif
+}
+
+// Allocator for byte grids: memory arrives zeroed (mapped pages or calloc)
+// and value-initialization is a no-op, so constructing a huge vector does
+// not touch, and therefore does not commit, any of its pages.
+template <class T>
+struct ZeroPageAllocator {
+    using value_type = T;
+
+    ZeroPageAllocator() = default;
+    template <class U>
+    ZeroPageAllocator(const ZeroPageAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        void *p = bytes >= kPageAllocThreshold ? pageAlloc(bytes) : std::calloc(n, sizeof(T));
+        if (!p) throw std::bad_alloc();
+        return (T *)p;
+    }
+    void deallocate(T *p, size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes >= kPageAllocThreshold) pageFree(p, bytes);
+        else std::free(p);
+    }
+
+    template <class U>
+    void construct(U *) noexcept {}
+    template <class U, class... Args>
+    void construct(U *p, Args &&...args) {
+        ::new ((void *)p) U(std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    bool operator==(const ZeroPageAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const ZeroPageAllocator<U> &) const { return false; }
+};
+
+//
+// ---------- Cold Page Codec ----------
+//
+// Compresses a page of byte-per-cell grid (every byte 0 or 1). Cells are
+// packed 64 to a word, then the words are stored as runs: a varint count of
+// zero words, a varint count of literal words, and the literals. Settled
+// ash is mostly zero words, so a 4 KiB page usually shrinks to a few dozen
+// bytes. Encoding fails, leaving the page as it is, if a byte is not 0 or 1.
+//
+inline void putVarint(std::vector<uint8_t> &out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+inline uint64_t getVarint(const uint8_t *&p) {
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+}
+
+// n must be a multiple of 64.
+inline bool encodeCellPage(const uint8_t *cells, size_t n, std::vector<uint8_t> &out) {
+    std::vector<uint64_t> words(n / 64);
+    uint8_t bad = 0;
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t x = 0;
+        for (int k = 0; k < 64; ++k) {
+            uint8_t c = cells[w * 64 + k];
+            bad |= c;
+            x |= (uint64_t)(c & 1) << k;
+        }
+        words[w] = x;
+    }
+    if (bad > 1) return false;
+    for (size_t w = 0; w < words.size();) {
+        size_t z = w;
+        while (z < words.size() && !words[z]) ++z;
+        size_t l = z;
+        while (l < words.size() && words[l]) ++l;
+        putVarint(out, z - w);
+        putVarint(out, l - z);
+        const uint8_t *lit = (const uint8_t *)&words[z];
+        out.insert(out.end(), lit, lit + (l - z) * 8);
+        w = l;
+    }
+    return true;
+}
+
+inline void decodeCellPage(const uint8_t *in, uint8_t *cells, size_t n) {
+    for (size_t w = 0; w < n / 64;) {
+        uint64_t zeros = getVarint(in), literals = getVarint(in);
+        std::fill_n(cells + w * 64, zeros * 64, 0);
+        w += zeros;
+        for (uint64_t i = 0; i < literals; ++i, ++w) {
+            uint64_t x;
+            std::memcpy(&x, in, 8);
+            in += 8;
+            for (int k = 0; k < 64; ++k) cells[w * 64 + k] = (uint8_t)((x >> k) & 1);
+        }
+    }
+}
+
+// Cell i of a packed page, read without unpacking the rest.
+inline uint8_t cellInPage(const uint8_t *in, size_t n, size_t i) {
+    const size_t target = i / 64;
+    for (size_t w = 0; w < n / 64;) {
+        uint64_t zeros = getVarint(in), literals = getVarint(in);
+        if (target < w + zeros) return 0;
+        w += zeros;
+        if (target < w + literals) {
+            uint64_t x;
+            std::memcpy(&x, in + (target - w) * 8, 8);
+            return (uint8_t)((x >> (i & 63)) & 1);
+        }
+        in += literals * 8;
+        w += literals;
+    }
+    return 0;
+}
@@ -0,0 +1,338 @@
+#pragma once
+#include "life_accel.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//
+// ---------- Pattern Parsing ----------
+//
+// RLE and Macrocell ([M2]) files are parsed straight into snapshot-layout
+// words. Macrocell patterns are cropped to their live bounding box, since
+// the quadtree root is usually far larger than the pattern.
+//
+struct PatternBits {
+    uint32_t rows = 0, cols = 0;
+    uint64_t wordsPerRow = 0;
+    std::vector<uint64_t> words;
+
+    void resize(uint32_t r, uint32_t c) {
+        rows = r;
+        cols = c;
+        wordsPerRow = (c + 63) / 64;
+        words.assign((size_t)r * wordsPerRow, 0);
+    }
+    // Sets cells [c, c + n) of row r; the caller keeps them inside the board.
+    void setRun(uint64_t r, uint64_t c, uint64_t n) {
+        uint64_t *w = &words[r * wordsPerRow];
+        while (n) {
+            uint64_t bit = c & 63, take = std::min<uint64_t>(n, 64 - bit);
+            w[c >> 6] |= (take == 64 ? ~0ull : ((1ull << take) - 1)) << bit;
+            c += take;
+            n -= take;
+        }
+    }
+};
+
+// Boards above this many bytes of words are refused instead of allocated.
+constexpr uint64_t kMaxPatternBytes = 1ull << 34;
+
+inline bool patternFail(std::string *error, const std::string &msg) {
+    if (error) *error = msg;
+    return false;
+}
+
+inline bool parseRle(const char *p, size_t n, PatternBits &out, std::string *error) {
+    const char *end = p + n;
+    uint64_t w = 0, h = 0;
+    bool header = false;
+    while (p < end && !header) {
+        const char *eol = std::find(p, end, '\n');
+        std::string line(p, eol);
+        p = eol < end ? eol + 1 : end;
+        if (line.empty() || line[0] == '#') continue;
+        unsigned long long x, y;
+        if (std::sscanf(line.c_str(), " x = %llu , y = %llu", &x, &y) != 2)
+            return patternFail(error, "RLE: missing \"x = , y =\" header");
+        w = x;
+        h = y;
+        header = true;
+    }
+    if (!header) return patternFail(error, "RLE: missing header");
+    if (w >= UINT32_MAX || h >= UINT32_MAX || h * ((w + 63) / 64) * 8 > kMaxPatternBytes)
+        return patternFail(error, "RLE: pattern too large");
+    out.resize((uint32_t)h, (uint32_t)w);
+
+    uint64_t r = 0, c = 0, count = 0;
+    for (; p < end && *p != '!'; ++p) {
+        char ch = *p;
+        if (ch >= '0' && ch <= '9') {
+            count = count * 10 + (ch - '0');
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') continue;
+        uint64_t k = count ? count : 1;
+        count = 0;
+        if (ch == '$') {
+            r += k;
+            c = 0;
+        } else if (ch == 'b' || ch == '.') {
+            c += k;
+        } else {
+            if (r >= h || c + k > w) return patternFail(error, "RLE: cells outside the x/y header");
+            out.setRun(r, c, k);
+            c += k;
+        }
+    }
+    return true;
+}
+
+inline bool parseMacrocell(const char *p, size_t n, PatternBits &out, std::string *error) {
+    struct Node {
+        int level;
+        uint32_t child[4];  // nw, ne, sw, se; 0 is the empty node
+        uint64_t leaf;      // level 3: 8x8 cells, row-major, bit 8 * y + x
+        int64_t top, left, bottom, right;  // live box in node coordinates, empty if bottom < top
+    };
+    std::vector<Node> nodes(1, Node{0, {0, 0, 0, 0}, 0, 0, 0, -1, -1});
+    const char *end = p + n;
+    bool first = true;
+    while (p < end) {
+        const char *eol = std::find(p, end, '\n');
+        std::string line(p, eol);
+        p = eol < end ? eol + 1 : end;
+        if (first) {
+            first = false;
+            if (line.compare(0, 4, "[M2]") != 0) return patternFail(error, "Macrocell: missing [M2]");
+            continue;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        Node nd{3, {0, 0, 0, 0}, 0, 0, 0, -1, -1};
+        if (line[0] == '.' || line[0] == '*' || line[0] == '$') {
+            int y = 0, x = 0;
+            for (char ch : line) {
+                if (ch == '$') { ++y; x = 0; continue; }
+                if (y >= 8 || x >= 8) return patternFail(error, "Macrocell: leaf wider than 8");
+                if (ch == '*') nd.leaf |= 1ull << (8 * y + x);
+                ++x;
+            }
+            for (int i = 0; i < 64; ++i)
+                if (nd.leaf >> i & 1) {
+                    int64_t yy = i / 8, xx = i % 8;
+                    if (nd.bottom < nd.top) { nd.top = nd.bottom = yy; nd.left = nd.right = xx; }
+                    nd.top = std::min(nd.top, yy); nd.bottom = std::max(nd.bottom, yy);
+                    nd.left = std::min(nd.left, xx); nd.right = std::max(nd.right, xx);
+                }
+        } else {
+            unsigned long long a, b, c, d;
+            if (std::sscanf(line.c_str(), "%d %llu %llu %llu %llu", &nd.level, &a, &b, &c, &d) != 5)
+                return patternFail(error, "Macrocell: bad node line \"" + line + "\"");
+            if (nd.level < 4 || nd.level > 40) return patternFail(error, "Macrocell: unsupported node level");
+            unsigned long long kids[4] = {a, b, c, d};
+            int64_t half = 1ll << (nd.level - 1);
+            for (int q = 0; q < 4; ++q) {
+                if (kids[q] >= nodes.size() || (kids[q] && nodes[kids[q]].level != nd.level - 1))
+                    return patternFail(error, "Macrocell: bad child reference");
+                nd.child[q] = (uint32_t)kids[q];
+                const Node &k = nodes[kids[q]];
+                if (k.bottom < k.top) continue;
+                int64_t dy = q >= 2 ? half : 0, dx = q & 1 ? half : 0;
+                if (nd.bottom < nd.top) {
+                    nd.top = k.top + dy;
+                    nd.left = k.left + dx;
+                    nd.bottom = k.bottom + dy;
+                    nd.right = k.right + dx;
+                }
+                nd.top = std::min(nd.top, k.top + dy);
+                nd.bottom = std::max(nd.bottom, k.bottom + dy);
+                nd.left = std::min(nd.left, k.left + dx);
+                nd.right = std::max(nd.right, k.right + dx);
+            }
+        }
+        nodes.push_back(nd);
+    }
+    if (nodes.size() < 2) return patternFail(error, "Macrocell: no nodes");
+
+    const Node &root = nodes.back();
+    if (root.bottom < root.top) {
+        out.resize(0, 0);
+        return true;
+    }
+    uint64_t h = root.bottom - root.top + 1, w = root.right - root.left + 1;
+    if (w >= UINT32_MAX || h >= UINT32_MAX || h * ((w + 63) / 64) * 8 > kMaxPatternBytes)
+        return patternFail(error, "Macrocell: pattern too large");
+    out.resize((uint32_t)h, (uint32_t)w);
+
+    // depth-first over non-empty nodes, placing leaves relative to the box
+    struct Item { uint32_t node; int64_t y, x; };
+    std::vector<Item> stack{{(uint32_t)nodes.size() - 1, -root.top, -root.left}};
+    while (!stack.empty()) {
+        Item it = stack.back();
+        stack.pop_back();
+        const Node &nd = nodes[it.node];
+        if (nd.level == 3) {
+            for (int y = 0; y < 8; ++y)
+                for (int x = 0; x < 8; ++x)
+                    if (nd.leaf >> (8 * y + x) & 1) out.setRun(it.y + y, it.x + x, 1);
+            continue;
+        }
+        int64_t half = 1ll << (nd.level - 1);
+        for (int q = 0; q < 4; ++q)
+            if (nd.child[q] && nodes[nd.child[q]].bottom >= nodes[nd.child[q]].top)
+                stack.push_back({nd.child[q], it.y + (q >= 2 ? half : 0), it.x + (q & 1 ? half : 0)});
+    }
+    return true;
+}
+
+inline bool parsePattern(const std::string &text, PatternBits &out, std::string *error) {
+    if (text.compare(0, 4, "[M2]") == 0) return parseMacrocell(text.data(), text.size(), out, error);
+    return parseRle(text.data(), text.size(), out, error);
+}
+
+//
+// ---------- Pattern Store ----------
+//
+// Content-addressed cache of parsed patterns. The source file is hashed, and
+// <hash>.snap in the cache directory holds its words in the snapshot format,
+// so a repeated load is a hash plus a memory map with no parsing at all.
+// Entries are written to a temporary name and renamed into place, so
+// concurrent runs sharing a cache never see a partial file. A hit refreshes
+// the entry's mtime; after each insert the least recently used entries are
+// evicted until the cache fits its byte and entry limits.
+//
+constexpr uint64_t kPatternCacheVersion = 1;  // bump when parsing changes
+
+inline uint64_t hashContent(const char *p, size_t n) {
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ (n * 0xff51afd7ed558ccdull) ^ kPatternCacheVersion;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+    }
+    for (; i < n; ++i) h = (h ^ (uint8_t)p[i]) * 0x100000001b3ull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 33);
+}
+
+class PatternStore {
+public:
+    explicit PatternStore(std::string dir, uint64_t maxBytes = 1ull << 30, size_t maxEntries = 256)
+        : dir(std::move(dir)), maxBytes(maxBytes), maxEntries(maxEntries) {}
+
+    // Maps the parsed form of `path`, parsing and caching it on a miss.
+    bool load(const std::string &path, MappedSnapshot &out, std::string *error = nullptr) {
+        namespace fs = std::filesystem;
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return patternFail(error, "cannot open " + path);
+        std::string text((size_t)in.tellg(), '\0');
+        in.seekg(0);
+        if (!in.read(&text[0], (std::streamsize)text.size())) return patternFail(error, "cannot read " + path);
+
+        char name[32];
+        std::snprintf(name, sizeof name, "%016llx.snap", (unsigned long long)hashContent(text.data(), text.size()));
+        std::string entry = dir + "/" + name;
+        std::error_code ec;
+        if (out.open(entry)) {
+            ++hits;
+            fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+            return true;
+        }
+
+        ++misses;
+        PatternBits bits;
+        std::string msg;
+        if (!parsePattern(text, bits, &msg)) return patternFail(error, path + ": " + msg);
+        fs::create_directories(dir, ec);
+        std::string tmp = entry + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        if (!writeEntry(tmp, bits)) {
+            fs::remove(tmp, ec);
+            return patternFail(error, "cannot write " + tmp);
+        }
+        fs::rename(tmp, entry, ec);
+        if (ec) return patternFail(error, "cannot write " + entry);
+        evict(entry);
+        if (!out.open(entry)) return patternFail(error, out.error());
+        return true;
+    }
+
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+
+private:
+    std::string dir;
+    uint64_t maxBytes;
+    size_t maxEntries;
+    uint64_t hits = 0, misses = 0;
+
+    static bool writeEntry(const std::string &path, const PatternBits &bits) {
+        std::ofstream f(path, std::ios::binary);
+        SnapshotHeader h = makeSnapshotHeader(bits.rows, bits.cols);
+        f.write((const char *)&h, sizeof h);
+        f.write((const char *)bits.words.data(), (std::streamsize)(bits.words.size() * 8));
+        return (bool)f;
+    }
+
+    void evict(const std::string &keep) {
+        namespace fs = std::filesystem;
+        struct Entry { fs::path path; fs::file_time_type used; uint64_t bytes; };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        std::error_code ec;
+        for (const auto &de : fs::directory_iterator(dir, ec)) {
+            if (de.path().extension() != ".snap") continue;
+            Entry e{de.path(), de.last_write_time(ec), (uint64_t)de.file_size(ec)};
+            total += e.bytes;
+            entries.push_back(e);
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.used < b.used; });
+        size_t count = entries.size();
+        for (const Entry &e : entries) {
+            if (total <= maxBytes && count <= maxEntries) break;
+            if (e.path == fs::path(keep)) continue;
+            if (fs::remove(e.path, ec)) {
+                total -= e.bytes;
+                --count;
+            }
+        }
+    }
+};
+
+// Copies a pattern onto the board with its top-left cell at (top, left),
+// clipped to the board. rowWords(r) returns pattern row r in snapshot words.
+template <class RowFn>
+void stampPattern(LifeAccel &life, uint32_t patRows, uint64_t wordsPerRow, RowFn rowWords, int top, int left) {
+    uint8_t *cells = life.cells();
+    const int rows = life.getRows(), cols = life.getCols();
+    for (uint32_t r = 0; r < patRows; ++r) {
+        int y = top + (int)r;
+        if (y < 0 || y >= rows) continue;
+        const uint64_t *words = rowWords(r);
+        for (uint64_t w = 0; w < wordsPerRow; ++w)
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                int x = left + (int)(w * 64 + __builtin_ctzll(bits));
+                if (x >= 0 && x < cols) cells[(size_t)y * cols + x] = 1;
+            }
+    }
+}
+
+inline void stampPattern(LifeAccel &life, const MappedSnapshot &pat, int top, int left) {
+    stampPattern(life, pat.header().rows, pat.header().wordsPerRow,
+                 [&](uint32_t r) { return pat.row(r); }, top, left);
+}
+
+inline void stampPattern(LifeAccel &life, const PatternBits &pat, int top, int left) {
+    stampPattern(life, pat.rows, pat.wordsPerRow,
+                 [&](uint32_t r) { return &pat.words[(size_t)r * pat.wordsPerRow]; }, top, left);
+}
@@ -0,0 +1,179 @@
+"""ctypes bindings for the LifeAccel C API (life_capi.h).
+
+The board is exposed without copying: ``Life.grid`` is a read-only 2-D
+memoryview (rows x cols, one byte per cell) over the engine's own buffer,
+so ``numpy.asarray(life.grid)`` is a zero-copy array. ``mutable_grid()``
+returns a writable view; taking it wakes every sleeping tile. A view keeps
+its engine alive, and ``close()`` refuses while any view, or an array made
+from one, still exists. ctypes drops
+the GIL for the duration of every foreign call, so ``step`` runs
+concurrently with other Python threads.
+
+The library is looked up in $LIFEACCEL_LIB, then next to this file.
+"""
+
+import ctypes
+import os
+import struct
+import sys
+import weakref
+
+_API_VERSION = 2
+
+
+class Metrics(ctypes.Structure):
+    _fields_ = [
+        ("generation", ctypes.c_int64),
+        ("live", ctypes.c_int64),
+        ("delta", ctypes.c_int64),
+        ("step_ms", ctypes.c_double),
+        ("period", ctypes.c_int64),
+        ("dx", ctypes.c_int32),
+        ("dy", ctypes.c_int32),
+        ("sleeping_tiles", ctypes.c_int32),
+        ("tiles", ctypes.c_int32),
+    ]
+
+
+def _load():
+    path = os.environ.get("LIFEACCEL_LIB")
+    if not path:
+        name = {"win32": "liblifeaccel.dll", "darwin": "liblifeaccel.dylib"}.get(
+            sys.platform, "liblifeaccel.so")
+        path = os.path.join(os.path.dirname(os.path.abspath(__file__)), name)
+    lib = ctypes.CDLL(path)
+
+    P = ctypes.c_void_p
+    i32 = ctypes.c_int32
+    sigs = {
+        "life_api_version": (ctypes.c_uint32, []),
+        "life_create": (P, [i32, i32, i32]),
+        "life_destroy": (None, [P]),
+        "life_randomize": (None, [P, ctypes.c_double]),
+        "life_step": (None, [P, i32]),
+        "life_load_snapshot": (i32, [P, ctypes.c_char_p]),
+        "life_save_snapshot": (i32, [P, ctypes.c_char_p]),
+        "life_last_error": (ctypes.c_char_p, [P]),
+        "life_cells": (ctypes.POINTER(ctypes.c_uint8),
+                       [P, ctypes.POINTER(i32), ctypes.POINTER(i32)]),
+        "life_cells_view": (ctypes.POINTER(ctypes.c_uint8),
+                            [P, ctypes.POINTER(i32), ctypes.POINTER(i32)]),
+        "life_get_metrics": (None, [P, ctypes.POINTER(Metrics)]),
+        "life_population": (ctypes.c_int64, [P, i32, i32, i32, i32]),
+    }
+    for fn, (res, args) in sigs.items():
+        getattr(lib, fn).restype = res
+        getattr(lib, fn).argtypes = args
+
+    if lib.life_api_version() != _API_VERSION:
+        raise ImportError("lifeaccel: library API version %d, expected %d"
+                          % (lib.life_api_version(), _API_VERSION))
+    return lib
+
+
+_lib = _load()
+
+
+class Life:
+    def __init__(self, cols, rows, threads=0):
+        self._views = []  # weakrefs to the ctypes buffers under grid views
+        self._h = _lib.life_create(cols, rows, threads)
+        if not self._h:
+            raise MemoryError("life_create(%d, %d) failed" % (cols, rows))
+
+    @classmethod
+    def from_snapshot(cls, path, threads=0):
+        """Creates an engine sized to the snapshot and loads it."""
+        with open(path, "rb") as f:
+            magic, cols, rows = struct.unpack("<8sII", f.read(16))
+        if magic != b"LIFESNP1":
+            raise ValueError("%s: not a snapshot" % path)
+        life = cls(cols, rows, threads)
+        life.load_snapshot(path)
+        return life
+
+    def close(self):
+        """Destroys the engine.
+
+        Raises BufferError while grid views are alive, since they would
+        point into freed memory.
+        """
+        if not self._h:
+            return
+        views = self._live_views()
+        if views:
+            raise BufferError("Life.close(): %d grid view(s) still alive" % views)
+        _lib.life_destroy(self._h)
+        self._h = None
+
+    def __del__(self):
+        # every view holds a reference to its engine, so normally none is
+        # left here; if one is (interpreter teardown), leak rather than free
+        if getattr(self, "_h", None) and not self._live_views():
+            self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def randomize(self, fill=0.25):
+        _lib.life_randomize(self._h, fill)
+
+    def step(self, generations=1):
+        _lib.life_step(self._h, generations)
+
+    def load_snapshot(self, path):
+        if _lib.life_load_snapshot(self._h, os.fsencode(path)) != 0:
+            raise OSError(_lib.life_last_error(self._h).decode())
+
+    def save_snapshot(self, path):
+        if _lib.life_save_snapshot(self._h, os.fsencode(path)) != 0:
+            raise OSError(_lib.life_last_error(self._h).decode())
+
+    @property
+    def grid(self):
+        """Read-only zero-copy rows x cols view of the current generation.
+
+        The engine double-buffers, so a view taken before ``step`` refers
+        to the previous buffer afterwards; fetch ``grid`` again.
+        """
+        return self._view(_lib.life_cells_view).toreadonly()
+
+    def mutable_grid(self):
+        """Writable view of the current generation, valid until ``step``."""
+        return self._view(_lib.life_cells)
+
+    def _view(self, fn):
+        if not self._h:
+            raise ValueError("Life is closed")
+        rows, cols = ctypes.c_int32(), ctypes.c_int32()
+        ptr = fn(self._h, ctypes.byref(rows), ctypes.byref(cols))
+        buf = (ctypes.c_uint8 * (rows.value * cols.value)).from_address(
+            ctypes.addressof(ptr.contents))
+        # every memoryview and numpy array over the view keeps `buf` alive,
+        # and `buf` keeps the engine alive
+        buf._owner = self
+        self._views = [r for r in self._views if r() is not None]
+        self._views.append(weakref.ref(buf))
+        return memoryview(buf).cast("B", (rows.value, cols.value))
+
+    def _live_views(self):
+        return sum(1 for r in self._views if r() is not None)
+
+    def population(self, x, y, w, h):
+        """Live cells in the w x h rect at column x, row y, clipped to the board.
+
+        Answered from the engine's tile population pyramid and per-tile row
+        and column counts; only the tiles at the rect's corners are scanned,
+        so the cost grows with the perimeter over the tile size, not the
+        area, and regions can be polled every generation.
+        """
+        return _lib.life_population(self._h, x, y, w, h)
+
+    @property
+    def metrics(self):
+        m = Metrics()
+        _lib.life_get_metrics(self._h, ctypes.byref(m))
+        return m
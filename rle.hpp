@@ -0,0 +1,172 @@
+#pragma once
+#include "life_accel.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//
+// ---------- RLE Writer ----------
+//
+// Writes the standard Life RLE format: an "x = , y = , rule =" header, then
+// <count><tag> tokens (b dead, o live, $ end of row) closed by '!', wrapped
+// so no line exceeds 70 characters. Dead cells at the end of a row and empty
+// rows at the end of the board are left out.
+//
+// The board is cut into horizontal slabs that the pool encodes straight from
+// bit-packed rows, finding run ends with count-trailing-zeros. Runs never
+// cross a row, so the only thing slabs share is a run of empty rows across
+// their boundary: each slab reports the empty rows before and after its
+// body, and the stitcher folds them into a single "n$" token. Slabs are
+// encoded and written a batch at a time, so memory stays bounded.
+//
+struct RleSlab {
+    uint64_t lead = 0;   // row ends before the first non-empty row
+    uint64_t trail = 0;  // row ends from the last non-empty row to the slab end
+    std::string body;    // tokens from the first to the last non-empty row
+};
+
+inline void appendRleRun(std::string &s, uint64_t n, char tag) {
+    if (n > 1) {
+        char buf[24];
+        s.append(buf, std::to_chars(buf, buf + sizeof buf, n).ptr);
+    }
+    s += tag;
+}
+
+// First bit at or after `from` equal to `one`, or nw * 64 if there is none.
+inline uint64_t findRleBit(const uint64_t *words, uint64_t nw, uint64_t from, bool one) {
+    uint64_t w = from >> 6;
+    if (w >= nw) return nw * 64;
+    uint64_t flip = one ? 0 : ~0ull;
+    uint64_t x = (words[w] ^ flip) & (~0ull << (from & 63));
+    while (!x) {
+        if (++w == nw) return nw * 64;
+        x = words[w] ^ flip;
+    }
+    return w * 64 + __builtin_ctzll(x);
+}
+
+// Appends the runs of one row, without its trailing dead cells or '$'.
+inline void encodeRleRow(const uint64_t *words, uint64_t cols, std::string &out) {
+    const uint64_t nw = (cols + 63) / 64;
+    uint64_t pos = 0;
+    for (;;) {
+        uint64_t b = findRleBit(words, nw, pos, true);
+        if (b >= cols) return;
+        uint64_t e = std::min(cols, findRleBit(words, nw, b, false));
+        if (b > pos) appendRleRun(out, b - pos, 'b');
+        appendRleRun(out, e - b, 'o');
+        pos = e;
+    }
+}
+
+// Writes tokens, breaking lines between tokens at `width` characters.
+class RleLineWriter {
+public:
+    RleLineWriter(std::ostream &out, size_t width) : out(out), width(width) {}
+
+    void run(uint64_t n, char tag) {
+        tok.clear();
+        appendRleRun(tok, n, tag);
+        tokens(tok);
+    }
+    void tokens(const std::string &s) {
+        for (size_t i = 0; i < s.size();) {
+            size_t j = i;
+            while (s[j] >= '0' && s[j] <= '9') ++j;
+            size_t len = j + 1 - i;
+            if (col && col + len > width) {
+                buf += '\n';
+                col = 0;
+            }
+            buf.append(s, i, len);
+            col += len;
+            i = j + 1;
+            if (buf.size() >= (1 << 20)) flush();
+        }
+    }
+    void flush() {
+        out.write(buf.data(), (std::streamsize)buf.size());
+        buf.clear();
+    }
+
+private:
+    std::ostream &out;
+    size_t width, col = 0;
+    std::string buf, tok;
+};
+
+// rowWords(r, scratch) returns row r as snapshot words; it may pack into
+// `scratch`, which is private to the calling worker.
+template <class RowFn>
+bool writeRle(std::ostream &out, ThreadPool &pool, uint64_t rows, uint64_t cols, RowFn rowWords,
+              const char *rule = "B3/S23") {
+    out << "x = " << cols << ", y = " << rows << ", rule = " << rule << "\n";
+    const uint64_t nThreads = std::max<size_t>(1, pool.size());
+    const uint64_t slabRows = std::max<uint64_t>(16, (rows + nThreads * 8 - 1) / (nThreads * 8));
+    const uint64_t nSlabs = (rows + slabRows - 1) / slabRows;
+    const uint64_t batch = nThreads * 2;
+
+    RleLineWriter lw(out, 70);
+    std::vector<RleSlab> slabs(std::min(batch, nSlabs));
+    uint64_t pending = 0;  // row ends not yet written
+    for (uint64_t s0 = 0; s0 < nSlabs; s0 += batch) {
+        uint64_t s1 = std::min(nSlabs, s0 + batch);
+        for (uint64_t s = s0; s < s1; ++s)
+            pool.enqueue([&, s]() {
+                static thread_local std::vector<uint64_t> scratch;
+                static thread_local std::string row;
+                RleSlab &slab = slabs[s - s0];
+                slab = RleSlab();
+                uint64_t r0 = s * slabRows, r1 = std::min(rows, r0 + slabRows);
+                bool seen = false;
+                uint64_t ends = 0;
+                for (uint64_t r = r0; r < r1; ++r, ++ends) {
+                    row.clear();
+                    encodeRleRow(rowWords(r, scratch), cols, row);
+                    if (row.empty()) continue;
+                    if (seen) appendRleRun(slab.body, ends, '$');
+                    else slab.lead = ends;
+                    slab.body += row;
+                    seen = true;
+                    ends = 0;
+                }
+                if (seen) slab.trail = ends;
+                else slab.lead = ends;
+            });
+        pool.waitAll();
+
+        for (uint64_t s = s0; s < s1; ++s) {
+            RleSlab &slab = slabs[s - s0];
+            pending += slab.lead;
+            if (slab.body.empty()) continue;
+            if (pending) lw.run(pending, '$');
+            lw.tokens(slab.body);
+            pending = slab.trail;
+        }
+    }
+    lw.run(1, '!');
+    lw.flush();
+    out << "\n";
+    return (bool)out;
+}
+
+inline bool writeRle(std::ostream &out, ThreadPool &pool, const MappedSnapshot &snap) {
+    return writeRle(out, pool, snap.header().rows, snap.header().cols,
+                    [&](uint64_t r, std::vector<uint64_t> &) { return snap.row((uint32_t)r); });
+}
+
+inline bool writeRle(std::ostream &out, ThreadPool &pool, const LifeAccel &life) {
+    const uint8_t *cells = life.cells();
+    const uint64_t cols = life.getCols();
+    return writeRle(out, pool, life.getRows(), cols, [=](uint64_t r, std::vector<uint64_t> &words) {
+        words.assign((cols + 63) / 64, 0);
+        const uint8_t *row = cells + r * cols;
+        for (uint64_t c = 0; c < cols; ++c) words[c >> 6] |= (uint64_t)row[c] << (c & 63);
+        return (const uint64_t *)words.data();
+    });
+}
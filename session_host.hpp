@@ -0,0 +1,275 @@
+#pragma once
+#include "life_accel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// ---------- Session Host ----------
+//
+// Runs many independent boards in one process on one shared ThreadPool. A
+// step of any session occupies the whole pool (updateParallel ends in
+// waitAll), so sessions take turns a step at a time, and scheduling decides
+// whose step runs next:
+//
+//  - Weighted fair: a session's virtual time advances by the wall time of
+//    each of its steps divided by its weight. The runnable session with the
+//    least virtual time goes next, so pool time is shared in proportion to
+//    weight whatever the board sizes. A new or resumed session starts at
+//    the current virtual clock and gets no credit for time away.
+//  - CPU quota: pool time used decays with time constant `window`. A
+//    session whose recent use exceeds quota x window sits out until it has
+//    decayed back under.
+//  - Memory quota: a session's two generation grids must fit its own limit
+//    and what is left of the host budget. This is checked when it is added.
+//
+struct SessionConfig {
+    std::string name;
+    int cols = 256, rows = 256;
+    double weight = 1;    // relative share of pool time
+    double cpuQuota = 1;  // at most this fraction of pool time
+    size_t memQuota = 0;  // grid bytes; 0: only the host budget applies
+};
+
+struct SessionMetrics {
+    int id = -1;
+    std::string name;
+    long long generation = 0;
+    int live = 0;
+    double stepMs = 0;       // recent average
+    double cpuShare = 0;     // fraction of pool time over the window
+    double stepsPerSec = 0;  // over the window
+    size_t gridBytes = 0, residentBytes = 0;
+    long long throttled = 0;  // turns lost to the CPU quota
+    bool paused = false;
+};
+
+class SessionHost {
+public:
+    using clock = std::chrono::steady_clock;
+
+    SessionHost(ThreadPool &pool, size_t memBudget, double windowMs = 1000)
+        : pool(pool), memBudget(memBudget), windowMs(windowMs) {}
+    ~SessionHost() { stop(); }
+
+    // Returns the session id, or -1 with `error` set.
+    int add(const SessionConfig &cfg, std::string *error = nullptr) {
+        auto fail = [&](const std::string &msg) {
+            if (error) *error = cfg.name + ": " + msg;
+            return -1;
+        };
+        if (cfg.cols <= 0 || cfg.rows <= 0) return fail("empty board");
+        if (!(cfg.weight > 0)) return fail("weight must be positive");
+        if (!(cfg.cpuQuota > 0 && cfg.cpuQuota <= 1)) return fail("cpu quota must be in (0, 1]");
+        const size_t bytes = 2 * (size_t)cfg.cols * cfg.rows;
+        auto mb = [](size_t b) {
+            char buf[32];
+            std::snprintf(buf, sizeof buf, "%.1f MB", b / 1048576.0);
+            return std::string(buf);
+        };
+        if (cfg.memQuota && bytes > cfg.memQuota)
+            return fail("needs " + mb(bytes) + ", quota is " + mb(cfg.memQuota));
+
+        std::lock_guard<std::mutex> lk(hostLock);
+        if (memUsed + bytes > memBudget)
+            return fail("needs " + mb(bytes) + ", host has " + mb(memBudget - memUsed) + " left");
+        auto s = std::make_shared<Session>();
+        s->cfg = cfg;
+        s->bytes = bytes;
+        s->life = std::make_unique<LifeAccel>(cfg.cols, cfg.rows, 1, pool);
+        s->vtime = vclock;
+        s->decayedAt = clock::now();
+        s->m.id = nextId;
+        s->m.name = cfg.name;
+        s->m.gridBytes = s->life->getGridBytes();
+        memUsed += bytes;
+        sessions[nextId] = s;
+        changes++;
+        wake.notify_all();
+        return nextId++;
+    }
+
+    bool remove(int id) {
+        std::lock_guard<std::mutex> lk(hostLock);
+        auto it = sessions.find(id);
+        if (it == sessions.end()) return false;
+        memUsed -= it->second->bytes;
+        sessions.erase(it);  // a step in flight keeps its session alive until it ends
+        return true;
+    }
+
+    bool setPaused(int id, bool paused) {
+        std::lock_guard<std::mutex> lk(hostLock);
+        auto it = sessions.find(id);
+        if (it == sessions.end()) return false;
+        Session &s = *it->second;
+        if (s.m.paused && !paused) s.vtime = std::max(s.vtime, vclock);
+        s.m.paused = paused;
+        changes++;
+        wake.notify_all();
+        return true;
+    }
+
+    bool setWeight(int id, double weight) {
+        std::lock_guard<std::mutex> lk(hostLock);
+        auto it = sessions.find(id);
+        if (it == sessions.end() || !(weight > 0)) return false;
+        it->second->cfg.weight = weight;
+        return true;
+    }
+
+    // Runs fn(LifeAccel &) on a session between its steps, e.g. to seed it.
+    template <class Fn>
+    bool with(int id, Fn fn) {
+        std::shared_ptr<Session> s;
+        {
+            std::lock_guard<std::mutex> lk(hostLock);
+            auto it = sessions.find(id);
+            if (it == sessions.end()) return false;
+            s = it->second;
+        }
+        std::lock_guard<std::mutex> lk(s->lock);
+        fn(*s->life);
+        return true;
+    }
+
+    // Makes one scheduling decision and runs that step on the calling thread.
+    // False when no session may run now; `retry` then says when one may.
+    bool stepNext(clock::duration *retry = nullptr) {
+        std::shared_ptr<Session> s;
+        {
+            std::lock_guard<std::mutex> lk(hostLock);
+            const auto now = clock::now();
+            Session *first = nullptr;  // least virtual time, quota or not
+            clock::duration wait = std::chrono::seconds(1);
+            for (auto &kv : sessions) {
+                Session &c = *kv.second;
+                if (c.m.paused) continue;
+                decay(c, now);
+                if (!first || c.vtime < first->vtime) first = &c;
+                double limit = c.cfg.cpuQuota * windowMs;
+                if (c.recentMs >= limit) {
+                    auto ms = std::chrono::duration<double, std::milli>(windowMs * std::log(c.recentMs / limit));
+                    wait = std::min(wait, std::chrono::duration_cast<clock::duration>(ms) + clock::duration(1));
+                    continue;
+                }
+                if (!s || c.vtime < s->vtime) s = kv.second;
+            }
+            if (first && first != s.get()) first->m.throttled++;
+            if (!s) {
+                if (retry) *retry = wait;
+                return false;
+            }
+            vclock = std::max(vclock, s->vtime);
+        }
+
+        double ms;
+        int live;
+        size_t resident;
+        {
+            std::lock_guard<std::mutex> lk(s->lock);
+            auto t0 = clock::now();
+            s->life->updateParallel();
+            ms = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+            live = s->life->getLiveCount();
+            resident = s->life->getResidentGridBytes();
+        }
+
+        std::lock_guard<std::mutex> lk(hostLock);
+        decay(*s, clock::now());
+        s->recentMs += ms;
+        s->recentSteps += 1;
+        s->vtime += ms / s->cfg.weight;
+        SessionMetrics &m = s->m;
+        m.generation++;
+        m.live = live;
+        m.residentBytes = resident;
+        m.stepMs = m.stepMs ? m.stepMs * 0.9 + ms * 0.1 : ms;
+        return true;
+    }
+
+    // Steps sessions on a scheduler thread until stop().
+    void start() {
+        running = true;
+        scheduler = std::thread([this] {
+            while (running) {
+                unsigned seen;
+                {
+                    std::lock_guard<std::mutex> lk(hostLock);
+                    seen = changes;
+                }
+                clock::duration retry;
+                if (stepNext(&retry)) continue;
+                std::unique_lock<std::mutex> lk(hostLock);
+                wake.wait_for(lk, retry, [&] { return !running || changes != seen; });
+            }
+        });
+    }
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lk(hostLock);
+            running = false;
+        }
+        wake.notify_all();
+        if (scheduler.joinable()) scheduler.join();
+    }
+
+    std::vector<SessionMetrics> metrics() {
+        std::lock_guard<std::mutex> lk(hostLock);
+        std::vector<SessionMetrics> out;
+        const auto now = clock::now();
+        for (auto &kv : sessions) {
+            Session &s = *kv.second;
+            decay(s, now);
+            s.m.cpuShare = s.recentMs / windowMs;
+            s.m.stepsPerSec = s.recentSteps / (windowMs / 1000);
+            out.push_back(s.m);
+        }
+        return out;
+    }
+
+    size_t getMemUsed() const { return memUsed; }
+    size_t getMemBudget() const { return memBudget; }
+
+private:
+    struct Session {
+        SessionConfig cfg;
+        std::unique_ptr<LifeAccel> life;
+        std::mutex lock;  // held while stepping and by with()
+        size_t bytes = 0;
+        double vtime = 0;
+        // pool time and steps, decaying with time constant windowMs
+        double recentMs = 0, recentSteps = 0;
+        clock::time_point decayedAt;
+        SessionMetrics m;
+    };
+
+    ThreadPool &pool;
+    size_t memBudget, memUsed = 0;
+    double windowMs;
+    double vclock = 0;  // virtual time of the latest pick
+    int nextId = 0;
+    std::map<int, std::shared_ptr<Session>> sessions;
+    std::mutex hostLock;
+    std::condition_variable wake;
+    std::thread scheduler;
+    std::atomic<bool> running{false};
+    unsigned changes = 0;  // bumped when a session becomes runnable
+
+    void decay(Session &s, clock::time_point now) {
+        double dt = std::chrono::duration<double, std::milli>(now - s.decayedAt).count();
+        double f = std::exp(-dt / windowMs);
+        s.recentMs *= f;
+        s.recentSteps *= f;
+        s.decayedAt = now;
+    }
+};
@@ -0,0 +1,26 @@
+#include "rle.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+//
+// ---------- snap2rle ----------
+//
+// usage: snap2rle <in.snap> <out.rle>
+// Converts a snapshot to RLE on all cores without expanding it to bytes.
+//
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "usage: snap2rle <in.snap> <out.rle>\n";
+        return 2;
+    }
+    MappedSnapshot snap;
+    if (!snap.open(argv[1])) { std::cerr << snap.error() << "\n"; return 2; }
+    std::ofstream out(argv[2], std::ios::binary);
+    ThreadPool pool;
+    if (!out || !writeRle(out, pool, snap)) {
+        std::cerr << "cannot write " << argv[2] << "\n";
+        return 2;
+    }
+    return 0;
+}
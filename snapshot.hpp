@@ -0,0 +1,318 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//
+// ---------- Snapshot Format ----------
+//
+// A snapshot is a fixed header followed by `rows` rows of `wordsPerRow`
+// little-endian 64-bit words. Cell (r, c) is bit c % 64 of word c / 64 in
+// row r; bits past `cols` in the last word of a row are always zero.
+//
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t cols, rows;
+    uint64_t wordsPerRow;
+};
+
+constexpr char kSnapshotMagic[8] = {'L', 'I', 'F', 'E', 'S', 'N', 'P', '1'};
+
+inline SnapshotHeader makeSnapshotHeader(uint32_t rows, uint32_t cols) {
+    SnapshotHeader h;
+    std::memcpy(h.magic, kSnapshotMagic, sizeof h.magic);
+    h.cols = cols;
+    h.rows = rows;
+    h.wordsPerRow = (cols + 63) / 64;
+    return h;
+}
+
+//
+// ---------- Mapped Snapshot ----------
+//
+// Read-only memory map of a snapshot file, so multi-gigabyte boards are
+// paged in by the OS instead of being read into a buffer.
+//
+class MappedSnapshot {
+public:
+    MappedSnapshot() = default;
+    MappedSnapshot(const MappedSnapshot &) = delete;
+    MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+    ~MappedSnapshot() { close(); }
+
+    bool open(const std::string &path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return fail("cannot open " + path);
+        LARGE_INTEGER sz;
+        GetFileSizeEx(file, &sz);
+        size = (size_t)sz.QuadPart;
+        if (size < sizeof(SnapshotHeader)) return fail(path + ": truncated header");
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return fail("cannot map " + path);
+        base = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!base) return fail("cannot map " + path);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail("cannot open " + path);
+        struct stat st;
+        fstat(fd, &st);
+        size = (size_t)st.st_size;
+        if (size < sizeof(SnapshotHeader)) return fail(path + ": truncated header");
+        void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return fail("cannot map " + path);
+        madvise(p, size, MADV_SEQUENTIAL);
+        base = (const uint8_t *)p;
+#endif
+        std::memcpy(&hdr, base, sizeof hdr);
+        if (std::memcmp(hdr.magic, kSnapshotMagic, sizeof hdr.magic) != 0)
+            return fail(path + ": not a snapshot");
+        if (hdr.wordsPerRow != (hdr.cols + 63) / 64 ||
+            size < sizeof hdr + (uint64_t)hdr.rows * hdr.wordsPerRow * 8)
+            return fail(path + ": corrupt or truncated");
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap((void *)base, size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        base = nullptr;
+        size = 0;
+    }
+
+    const SnapshotHeader &header() const { return hdr; }
+    const uint64_t *row(uint32_t r) const {
+        return (const uint64_t *)(base + sizeof hdr) + (size_t)r * hdr.wordsPerRow;
+    }
+    const std::string &error() const { return err; }
+
+private:
+    const uint8_t *base = nullptr;
+    size_t size = 0;
+    SnapshotHeader hdr{};
+    std::string err;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    bool fail(const std::string &msg) {
+        err = msg;
+        close();
+        return false;
+    }
+};
+
+//
+// ---------- Snapshot Diff ----------
+//
+// A region is a group of differing tiles that touch, diagonally included,
+// with the bounding box of the differing cells inside them.
+//
+struct DiffRegion {
+    uint32_t top = 0, left = 0, bottom = 0, right = 0;  // inclusive, in cells
+    uint64_t differing = 0;
+};
+
+struct SnapshotDiff {
+    uint64_t differing = 0;
+    // bounding box of differing cells, valid when differing > 0
+    uint32_t top = 0, left = 0, bottom = 0, right = 0;
+    // first differing tile in row-major tile order
+    uint32_t tileRow = 0, tileCol = 0;
+    // in row-major order of their first tile
+    std::vector<DiffRegion> regions;
+};
+
+// Bits set in x without the popcnt instruction, which the default x86-64
+// target lacks (__builtin_popcountll becomes a libgcc call there). Only
+// shifts, masks and adds, so a loop over a block vectorizes.
+inline uint64_t popcountSwar(uint64_t x) {
+    x -= (x >> 1) & 0x5555555555555555ull;
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    x += x >> 8;
+    x += x >> 16;
+    x += x >> 32;
+    return x & 0x7f;
+}
+
+// Differing cells of one tile, while its tile row is being scanned.
+struct DiffTile {
+    uint32_t top, bottom, left, right;
+    uint64_t count;
+};
+
+inline void noteDiff(DiffTile &t, uint32_t r, uint32_t lo, uint32_t hi, uint64_t count) {
+    if (!t.count) {
+        t.top = r;
+        t.left = lo;
+        t.right = hi;
+    } else {
+        t.left = std::min(t.left, lo);
+        t.right = std::max(t.right, hi);
+    }
+    t.bottom = r;
+    t.count += count;
+}
+
+// Scans row r in blocks of eight words. Each block is XORed once into a
+// local array and OR-reduced. Only a block with a difference is popcounted
+// and spread over the tiles it covers, so equal stretches cost one load per
+// word of each file.
+template <bool HardwarePopcnt>
+__attribute__((always_inline)) inline void diffRowBlocks(const uint64_t *pa, const uint64_t *pb, uint64_t nw,
+                                                         uint32_t r, uint32_t tile, DiffTile *tiles,
+                                                         uint64_t tileCols, const uint32_t *wordTile) {
+    uint64_t x[8], cnt[8];
+    for (uint64_t w0 = 0; w0 < nw; w0 += 8) {
+        uint64_t any = 0;
+        if (nw - w0 >= 8) {
+            for (int k = 0; k < 8; ++k) {
+                x[k] = pa[w0 + k] ^ pb[w0 + k];
+                any |= x[k];
+            }
+        } else {
+            for (uint64_t k = 0; k < 8; ++k) {
+                x[k] = w0 + k < nw ? pa[w0 + k] ^ pb[w0 + k] : 0;
+                any |= x[k];
+            }
+        }
+        if (!any) continue;
+        for (int k = 0; k < 8; ++k) cnt[k] = HardwarePopcnt ? (uint64_t)__builtin_popcountll(x[k]) : popcountSwar(x[k]);
+        for (int k = 0; k < 8; ++k) {
+            if (!x[k]) continue;
+            const uint64_t base = (w0 + k) * 64;
+            if (tile % 64 == 0) {  // the word lies in one tile
+                noteDiff(tiles[wordTile[w0 + k]], r, (uint32_t)(base + __builtin_ctzll(x[k])),
+                         (uint32_t)(base + 63 - __builtin_clzll(x[k])), cnt[k]);
+                continue;
+            }
+            const uint64_t t1 = std::min<uint64_t>((base + 63) / tile, tileCols - 1);
+            for (uint64_t t = base / tile; t <= t1; ++t) {
+                uint64_t lo = std::max<uint64_t>(t * tile, base) - base, hi = std::min<uint64_t>((t + 1) * tile, base + 64) - base;
+                uint64_t mask = (hi - lo == 64 ? ~0ull : ((1ull << (hi - lo)) - 1)) << lo, y = x[k] & mask;
+                if (y)
+                    noteDiff(tiles[t], r, (uint32_t)(base + __builtin_ctzll(y)), (uint32_t)(base + 63 - __builtin_clzll(y)),
+                             popcountSwar(y));
+            }
+        }
+    }
+}
+
+using DiffRowFn = void (*)(const uint64_t *, const uint64_t *, uint64_t, uint32_t, uint32_t, DiffTile *, uint64_t,
+                           const uint32_t *);
+
+inline void diffRowPortable(const uint64_t *pa, const uint64_t *pb, uint64_t nw, uint32_t r, uint32_t tile,
+                            DiffTile *tiles, uint64_t tileCols, const uint32_t *wordTile) {
+    diffRowBlocks<false>(pa, pb, nw, r, tile, tiles, tileCols, wordTile);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// The project builds for baseline x86-64, so the AVX2 + popcnt version is
+// compiled separately and chosen at run time.
+__attribute__((target("avx2,popcnt"))) inline void diffRowAvx2(const uint64_t *pa, const uint64_t *pb, uint64_t nw,
+                                                               uint32_t r, uint32_t tile, DiffTile *tiles,
+                                                               uint64_t tileCols, const uint32_t *wordTile) {
+    diffRowBlocks<true>(pa, pb, nw, r, tile, tiles, tileCols, wordTile);
+}
+#endif
+
+inline DiffRowFn pickDiffRow() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return diffRowAvx2;
+#endif
+    return diffRowPortable;
+}
+
+// Compares two snapshots of equal dimensions. Differing tiles are collected
+// at the end of each tile row and joined to their differing neighbours in
+// that row and the row above with a union-find; regions are its sets.
+inline SnapshotDiff diffSnapshots(const MappedSnapshot &a, const MappedSnapshot &b, uint32_t tile = 64) {
+    const SnapshotHeader &h = a.header();
+    const uint64_t nw = h.wordsPerRow;
+    const uint64_t tileCols = std::max<uint64_t>(1, (h.cols + tile - 1) / tile);
+    const DiffRowFn diffRow = pickDiffRow();
+    std::vector<uint32_t> wordTile(nw);  // saves a division per differing word
+    for (uint64_t w = 0; w < nw; ++w) wordTile[w] = (uint32_t)(w * 64 / tile);
+
+    std::vector<DiffTile> found, row(tileCols, DiffTile{0, 0, 0, 0, 0});
+    std::vector<uint32_t> parent;
+    std::vector<int64_t> above(tileCols, -1), here(tileCols, -1);  // found index by tile column
+    auto root = [&](uint32_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    auto join = [&](int64_t i, int64_t j) {
+        if (j >= 0) parent[root((uint32_t)j)] = root((uint32_t)i);
+    };
+    int64_t firstTile = -1;
+    for (uint32_t r = 0; r < h.rows; ++r) {
+        diffRow(a.row(r), b.row(r), nw, r, tile, row.data(), tileCols, wordTile.data());
+        if (r % tile != tile - 1 && r + 1 != h.rows) continue;
+        for (uint64_t t = 0; t < tileCols; ++t) {
+            here[t] = -1;
+            if (!row[t].count) continue;
+            if (firstTile < 0) firstTile = (int64_t)((r / tile) * tileCols + t);
+            int64_t i = (int64_t)found.size();
+            here[t] = i;
+            found.push_back(row[t]);
+            parent.push_back((uint32_t)i);
+            row[t].count = 0;
+            if (t) join(i, here[t - 1]);
+            for (uint64_t c = t ? t - 1 : 0; c <= std::min(t + 1, tileCols - 1); ++c) join(i, above[c]);
+        }
+        above.swap(here);
+    }
+
+    SnapshotDiff d;
+    if (found.empty()) return d;
+    std::vector<int64_t> regionOf(found.size(), -1);
+    d.top = d.left = UINT32_MAX;
+    for (uint32_t i = 0; i < found.size(); ++i) {
+        const DiffTile &t = found[i];
+        uint32_t ri = root(i);
+        if (regionOf[ri] < 0) {
+            regionOf[ri] = (int64_t)d.regions.size();
+            d.regions.push_back({t.top, t.left, t.bottom, t.right, 0});
+        }
+        DiffRegion &g = d.regions[regionOf[ri]];
+        g.top = std::min(g.top, t.top);
+        g.left = std::min(g.left, t.left);
+        g.bottom = std::max(g.bottom, t.bottom);
+        g.right = std::max(g.right, t.right);
+        g.differing += t.count;
+        d.differing += t.count;
+        d.top = std::min(d.top, t.top);
+        d.left = std::min(d.left, t.left);
+        d.bottom = std::max(d.bottom, t.bottom);
+        d.right = std::max(d.right, t.right);
+    }
+    d.tileRow = (uint32_t)(firstTile / tileCols);
+    d.tileCol = (uint32_t)(firstTile % tileCols);
+    return d;
+}
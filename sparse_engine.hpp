@@ -0,0 +1,177 @@
+#pragma once
+#include "life_accel.hpp"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+//
+// ---------- Sparse Engine ----------
+//
+// The universe is 2^32 x 2^32 (wrapping) and only live cells are stored, as
+// sorted 64-bit keys (y << 32 | x). A step emits the eight neighbour keys of
+// every live cell, radix-sorts them on the pool, and reduces equal-key runs:
+// three tallies give a live cell, two keep one that is already live. Every
+// phase is linear in the population, independent of the universe size.
+//
+class SparseLife {
+public:
+    explicit SparseLife(ThreadPool &p) : pool(p) {}
+
+    static uint64_t key(uint32_t x, uint32_t y) { return (uint64_t)y << 32 | x; }
+    static uint32_t keyX(uint64_t k) { return (uint32_t)k; }
+    static uint32_t keyY(uint64_t k) { return (uint32_t)(k >> 32); }
+
+    void add(uint32_t x, uint32_t y) {
+        live.push_back(key(x, y));
+        sorted = false;
+    }
+
+    // Copies a dense board in with its top-left cell at (x0, y0).
+    static SparseLife fromDense(const LifeAccel &life, ThreadPool &p, uint32_t x0 = 0, uint32_t y0 = 0) {
+        SparseLife s(p);
+        const uint8_t *cells = life.cells();
+        for (int i = 0; i < life.getRows(); ++i)
+            for (int j = 0; j < life.getCols(); ++j)
+                if (cells[(size_t)i * life.getCols() + j])
+                    s.live.push_back(key(x0 + j, y0 + i));
+        s.sorted = false;  // the window may wrap past 2^32
+        return s;
+    }
+
+    // Writes the window whose top-left cell is (x0, y0) into a dense board.
+    void toDense(LifeAccel &life, uint32_t x0 = 0, uint32_t y0 = 0) {
+        normalize();
+        uint8_t *cells = life.cells();
+        std::fill(cells, cells + (size_t)life.getRows() * life.getCols(), 0);
+        for (uint64_t k : live) {
+            uint32_t dx = keyX(k) - x0, dy = keyY(k) - y0;
+            if (dx < (uint32_t)life.getCols() && dy < (uint32_t)life.getRows())
+                cells[(size_t)dy * life.getCols() + dx] = 1;
+        }
+    }
+
+    void step() {
+        normalize();
+        const size_t n = live.size();
+        if (!n) return;
+        const size_t nThreads = std::max<size_t>(1, pool.size());
+
+        // 1. neighbour contributions
+        tally.resize(n * 8);
+        forChunks(n, nThreads, [this](size_t, size_t b, size_t e) {
+            static const int d[8][2] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0},
+                                        {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+            for (size_t i = b; i < e; ++i) {
+                uint32_t x = keyX(live[i]), y = keyY(live[i]);
+                for (int k = 0; k < 8; ++k)
+                    tally[i * 8 + k] = key(x + d[k][0], y + d[k][1]);
+            }
+        });
+
+        // 2. sort
+        radixSort(tally, scratch, nThreads);
+
+        // 3. reduce equal-key runs; chunk starts are moved past the end of
+        //    the run they land in so no run is split between threads
+        const size_t m = tally.size();
+        std::vector<size_t> starts(nThreads + 1, m);
+        for (size_t t = 0; t < nThreads; ++t) {
+            size_t s = m * t / nThreads;
+            while (s > 0 && s < m && tally[s] == tally[s - 1]) ++s;
+            starts[t] = s;
+        }
+        std::vector<std::vector<uint64_t>> parts(nThreads);
+        for (size_t t = 0; t < nThreads; ++t)
+            pool.enqueue([&, t]() {
+                size_t i = starts[t], end = std::max(starts[t], starts[t + 1]);
+                std::vector<uint64_t> &out = parts[t];
+                if (i >= end) return;
+                auto alive = std::lower_bound(live.begin(), live.end(), tally[i]);
+                while (i < end) {
+                    uint64_t k = tally[i];
+                    size_t j = i + 1;
+                    while (j < end && tally[j] == k) ++j;
+                    size_t count = j - i;
+                    if (count == 3) {
+                        out.push_back(k);
+                    } else if (count == 2) {
+                        while (alive != live.end() && *alive < k) ++alive;
+                        if (alive != live.end() && *alive == k) out.push_back(k);
+                    }
+                    i = j;
+                }
+            });
+        pool.waitAll();
+
+        live.clear();
+        for (auto &p : parts) live.insert(live.end(), p.begin(), p.end());
+    }
+
+    size_t getLiveCount() {
+        normalize();
+        return live.size();
+    }
+    const std::vector<uint64_t> &cells() {
+        normalize();
+        return live;
+    }
+
+private:
+    ThreadPool &pool;
+    std::vector<uint64_t> live, tally, scratch;
+    bool sorted = true;
+
+    void normalize() {
+        if (sorted) return;
+        std::sort(live.begin(), live.end());
+        live.erase(std::unique(live.begin(), live.end()), live.end());
+        sorted = true;
+    }
+
+    template <class Fn>
+    void forChunks(size_t n, size_t nThreads, Fn fn) {
+        for (size_t t = 0; t < nThreads; ++t) {
+            size_t b = n * t / nThreads, e = n * (t + 1) / nThreads;
+            if (b < e) pool.enqueue([=]() { fn(t, b, e); });
+        }
+        pool.waitAll();
+    }
+
+    // LSD radix sort, 8 bits per pass. Each thread histograms and scatters
+    // its own slice; passes where every key shares the digit are skipped,
+    // which drops most high bytes when the population is clustered.
+    void radixSort(std::vector<uint64_t> &keys, std::vector<uint64_t> &tmp, size_t nThreads) {
+        const size_t n = keys.size();
+        tmp.resize(n);
+        std::vector<std::array<size_t, 256>> hist(nThreads);
+        for (int shift = 0; shift < 64; shift += 8) {
+            forChunks(n, nThreads, [&](size_t t, size_t b, size_t e) {
+                hist[t].fill(0);
+                for (size_t i = b; i < e; ++i) ++hist[t][(keys[i] >> shift) & 0xff];
+            });
+            for (size_t t = 0; t < nThreads; ++t)
+                if (n * t / nThreads == n * (t + 1) / nThreads) hist[t].fill(0);
+
+            bool trivial = false;
+            size_t offset = 0;
+            for (int d = 0; d < 256 && !trivial; ++d) {
+                size_t total = 0;
+                for (size_t t = 0; t < nThreads; ++t) total += hist[t][d];
+                trivial = total == n;
+            }
+            if (trivial) continue;
+            for (int d = 0; d < 256; ++d)
+                for (size_t t = 0; t < nThreads; ++t) {
+                    size_t c = hist[t][d];
+                    hist[t][d] = offset;
+                    offset += c;
+                }
+            forChunks(n, nThreads, [&](size_t t, size_t b, size_t e) {
+                std::array<size_t, 256> &pos = hist[t];
+                for (size_t i = b; i < e; ++i) tmp[pos[(keys[i] >> shift) & 0xff]++] = keys[i];
+            });
+            keys.swap(tmp);
+        }
+    }
+};
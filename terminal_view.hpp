@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+//
+// ---------- Terminal View ----------
+//
+// Draws the board as Unicode braille, 2x4 cells per character. The glyphs of
+// the last frame are kept, and a frame only writes the characters that
+// changed: each stretch of changes gets one cursor move. Unchanged gaps
+// shorter than a cursor move are rewritten rather than jumped over, so the
+// output is close to the smallest byte count for the update.
+//
+inline void terminalSize(int &cols, int &rows) {
+    cols = 80;
+    rows = 24;
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        cols = info.srWindow.Right - info.srWindow.Left + 1;
+        rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col && ws.ws_row) {
+        cols = ws.ws_col;
+        rows = ws.ws_row;
+    }
+#endif
+}
+
+class TerminalView {
+public:
+    // `rows` text lines of glyphs, plus one status line below them.
+    TerminalView(int cols, int rows) : cols(cols), rows(rows), shown((size_t)cols * rows, kUnknown) {}
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+
+    // Appends the escape sequences that bring the screen up to date with the
+    // board window whose top-left cell is (top, left). rowWords(r) returns
+    // board row r in snapshot words.
+    template <class RowFn>
+    void render(RowFn rowWords, int boardRows, int boardCols, int top, int left,
+                const std::string &status, std::string &out) {
+        if (first) {
+            out += "\x1b[?25l\x1b[2J";  // hide the cursor, clear
+            first = false;
+        }
+        glyphs.assign((size_t)cols * rows, 0);
+        for (int ty = 0; ty < rows; ++ty)
+            for (int dy = 0; dy < 4; ++dy) {
+                int r = top + ty * 4 + dy;
+                if (r < 0 || r >= boardRows) continue;
+                const uint64_t *w = rowWords(r);
+                for (int tx = 0; tx < cols; ++tx)
+                    for (int dx = 0; dx < 2; ++dx) {
+                        int c = left + tx * 2 + dx;
+                        if (c >= 0 && c < boardCols && (w[c >> 6] >> (c & 63) & 1))
+                            glyphs[(size_t)ty * cols + tx] |= kDot[dy][dx];
+                    }
+            }
+
+        for (int ty = 0; ty < rows; ++ty) {
+            uint16_t *old = &shown[(size_t)ty * cols];
+            const uint8_t *now = &glyphs[(size_t)ty * cols];
+            int cursor = -1;  // column the terminal cursor sits at on this line
+            for (int tx = 0; tx < cols; ++tx) {
+                if (old[tx] == now[tx]) continue;
+                // rewriting a short unchanged gap beats a 6-10 byte cursor move
+                if (cursor >= 0 && (tx - cursor) * 3 <= 8) {
+                    for (; cursor < tx; ++cursor) appendGlyph(out, now[cursor]);
+                } else {
+                    out += "\x1b[" + std::to_string(ty + 1) + ";" + std::to_string(tx + 1) + "H";
+                }
+                appendGlyph(out, now[tx]);
+                old[tx] = now[tx];
+                cursor = tx + 1;
+            }
+        }
+
+        if (status != shownStatus) {
+            out += "\x1b[" + std::to_string(rows + 1) + ";1H\x1b[K" + status;
+            shownStatus = status;
+        }
+    }
+
+    // Restores the cursor; call before exiting.
+    static std::string restore(int rows) {
+        return "\x1b[" + std::to_string(rows + 2) + ";1H\x1b[?25h";
+    }
+
+private:
+    static constexpr uint16_t kUnknown = 0x100;  // forces the first draw
+    static constexpr uint8_t kDot[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+
+    int cols, rows;
+    std::vector<uint16_t> shown;  // glyph on screen, or kUnknown
+    std::vector<uint8_t> glyphs;
+    std::string shownStatus;
+    bool first = true;
+
+    // U+2800 + bits, as three UTF-8 bytes; a blank cell stays a space.
+    static void appendGlyph(std::string &out, uint8_t bits) {
+        if (!bits) {
+            out += ' ';
+            return;
+        }
+        unsigned cp = 0x2800 + bits;
+        out += (char)(0xe0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3f));
+        out += (char)(0x80 | (cp & 0x3f));
+    }
+};
@@ -0,0 +1,258 @@
+#pragma once
+#include "life_accel.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+//
+// ---------- PNG Encoder ----------
+//
+// Grayscale PNGs only: 1-bit for cell-level tiles, 8-bit for density tiles.
+// `raw` holds the scanlines already prefixed with their filter byte (0), so
+// the whole image goes through zlib in one call.
+//
+inline void appendPngU32(std::vector<uint8_t> &out, uint32_t v) {
+    for (int s = 24; s >= 0; s -= 8) out.push_back((uint8_t)(v >> s));
+}
+
+inline void appendPngChunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, size_t n) {
+    appendPngU32(out, (uint32_t)n);
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + n);
+    uLong crc = crc32(0, (const Bytef *)type, 4);
+    if (n) crc = crc32(crc, data, (uInt)n);
+    appendPngU32(out, (uint32_t)crc);
+}
+
+inline bool encodePng(const std::vector<uint8_t> &raw, uint32_t w, uint32_t h, int depth, int level,
+                      std::vector<uint8_t> &out) {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    out.assign(signature, signature + 8);
+
+    uint8_t ihdr[13];
+    for (int i = 0; i < 4; ++i) {
+        ihdr[i] = (uint8_t)(w >> (24 - 8 * i));
+        ihdr[4 + i] = (uint8_t)(h >> (24 - 8 * i));
+    }
+    ihdr[8] = (uint8_t)depth;
+    ihdr[9] = 0;  // grayscale
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+    appendPngChunk(out, "IHDR", ihdr, sizeof ihdr);
+
+    static thread_local std::vector<uint8_t> z;
+    uLongf zn = compressBound((uLong)raw.size());
+    z.resize(zn);
+    if (compress2(z.data(), &zn, raw.data(), (uLong)raw.size(), level) != Z_OK) return false;
+    appendPngChunk(out, "IDAT", z.data(), zn);
+    appendPngChunk(out, "IEND", nullptr, 0);
+    return true;
+}
+
+//
+// ---------- Tile Pyramid Export ----------
+//
+// Writes the board as a pyramid of 256-pixel PNG tiles, the layout zoomable
+// image viewers read. Level L scales the board down by 2^(maxLevel - L), so
+// the top level is one pixel per cell and level 0 is 1x1. DeepZoom layout:
+//   <out>.dzi, <out>_files/<L>/<col>_<row>.png   (edge tiles cropped)
+// XYZ layout (opt.xyz):
+//   <out>/<z>/<x>/<y>.png                         (tiles padded to 256x256)
+// where z = 0 is the first level that fits in one tile.
+//
+// The top level is 1-bit, taken straight from the bit-packed rows. Levels
+// down to 128 cells per pixel count live cells per pixel with popcount, each
+// pass reading the board once. Meanwhile the top level leaves behind the
+// population of every 256x256 block, and all coarser levels are summed from
+// that small grid. Pixels use renderDensity's shading: 0 for dead, else
+// 64..255 rising with density.
+//
+// Tiles are rendered, encoded and written by the pool a batch at a time, so
+// memory stays at a few tiles per worker plus the block grid, whatever the
+// board size.
+//
+constexpr uint64_t kPyramidTile = 256;
+
+struct TilePyramidOptions {
+    bool xyz = false;
+    int compression = Z_DEFAULT_COMPRESSION;  // zlib level
+};
+
+// Live cells in columns [c0, c1) of a bit-packed row.
+inline uint64_t countRowBits(const uint64_t *words, uint64_t c0, uint64_t c1) {
+    uint64_t n = 0;
+    while (c0 < c1) {
+        uint64_t b = c0 & 63, e = std::min<uint64_t>(64, b + (c1 - c0));
+        uint64_t mask = (e == 64 ? ~0ull : (1ull << e) - 1) & (~0ull << b);
+        n += __builtin_popcountll(words[c0 >> 6] & mask);
+        c0 += e - b;
+    }
+    return n;
+}
+
+inline uint8_t pyramidShade(uint64_t live, uint64_t area) {
+    return live ? (uint8_t)(64 + 191 * std::min(live, area) / area) : (uint8_t)0;
+}
+
+inline bool writeTileFile(const std::filesystem::path &path, const std::vector<uint8_t> &png) {
+    std::ofstream f(path, std::ios::binary);
+    f.write((const char *)png.data(), (std::streamsize)png.size());
+    return (bool)f;
+}
+
+// rowWords(r) returns board row r as snapshot words; it is called from the
+// pool's workers concurrently.
+template <class RowFn>
+bool exportTilePyramid(ThreadPool &pool, uint64_t rows, uint64_t cols, RowFn rowWords, const std::string &out,
+                       const TilePyramidOptions &opt = {}, std::string *error = nullptr) {
+    namespace fs = std::filesystem;
+    constexpr uint64_t T = kPyramidTile;
+    if (!rows || !cols) {
+        if (error) *error = "empty board";
+        return false;
+    }
+    int maxLevel = 0;
+    while ((1ull << maxLevel) < std::max(rows, cols)) ++maxLevel;
+    const int minLevel = opt.xyz ? std::min(8, maxLevel) : 0;
+
+    uint8_t reverse[256];  // LSB-first snapshot bytes to MSB-first PNG bytes
+    for (int i = 0; i < 256; ++i) {
+        uint8_t r = 0;
+        for (int b = 0; b < 8; ++b) r |= (uint8_t)(((i >> b) & 1) << (7 - b));
+        reverse[i] = r;
+    }
+
+    const uint64_t gridRows = (rows + T - 1) / T, gridCols = (cols + T - 1) / T;
+    std::vector<uint64_t> grid(gridRows * gridCols, 0);  // live cells per 256x256 block
+    std::atomic<bool> failed{false};
+    std::mutex errorLock;
+    auto fail = [&](const std::string &msg) {
+        std::lock_guard<std::mutex> lk(errorLock);
+        if (!failed.exchange(true) && error) *error = msg;
+    };
+
+    const fs::path root = opt.xyz ? fs::path(out) : fs::path(out + "_files");
+    const uint64_t batch = std::max<size_t>(1, pool.size()) * 4;
+    for (int level = maxLevel; level >= minLevel && !failed; --level) {
+        const int shift = maxLevel - level;
+        const uint64_t s = 1ull << shift;  // cells per pixel, each way
+        const uint64_t imgW = (cols + s - 1) >> shift, imgH = (rows + s - 1) >> shift;
+        const uint64_t tilesX = (imgW + T - 1) / T, tilesY = (imgH + T - 1) / T;
+
+        const fs::path levelDir = root / std::to_string(opt.xyz ? level - minLevel : level);
+        std::error_code ec;
+        fs::create_directories(levelDir, ec);
+        for (uint64_t tx = 0; opt.xyz && !ec && tx < tilesX; ++tx)
+            fs::create_directories(levelDir / std::to_string(tx), ec);
+        if (ec) {
+            fail("cannot create " + levelDir.string() + ": " + ec.message());
+            break;
+        }
+
+        const uint64_t nTiles = tilesX * tilesY;
+        for (uint64_t t0 = 0; t0 < nTiles && !failed; t0 += batch) {
+            for (uint64_t t = t0; t < std::min(nTiles, t0 + batch); ++t)
+                pool.enqueue([&, t, s, shift, imgW, imgH, tilesX, levelDir]() {
+                    static thread_local std::vector<uint8_t> raw, png;
+                    static thread_local std::vector<uint64_t> live;
+                    const uint64_t tx = t % tilesX, ty = t / tilesX;
+                    const uint64_t x0 = tx * T, y0 = ty * T;
+                    const uint32_t w = (uint32_t)(opt.xyz ? T : std::min(T, imgW - x0));
+                    const uint32_t h = (uint32_t)(opt.xyz ? T : std::min(T, imgH - y0));
+                    const int depth = s == 1 ? 1 : 8;
+                    const size_t stride = ((size_t)w * depth + 7) / 8 + 1;
+                    raw.assign(stride * h, 0);
+                    // pixels inside the image; xyz tiles are padded past it
+                    const uint64_t pw = std::min<uint64_t>(w, imgW - x0), ph = std::min<uint64_t>(h, imgH - y0);
+
+                    if (s == 1) {
+                        uint64_t total = 0;
+                        for (uint64_t y = 0; y < ph; ++y) {
+                            const uint64_t *words = rowWords(y0 + y);
+                            const uint8_t *src = (const uint8_t *)words + x0 / 8;
+                            uint8_t *dst = &raw[y * stride + 1];
+                            size_t nb = (size_t)(pw + 7) / 8;
+                            for (size_t b = 0; b < nb; ++b) dst[b] = reverse[src[b]];
+                            if (pw & 7) dst[nb - 1] &= (uint8_t)(0xff << (8 - (pw & 7)));
+                            total += countRowBits(words, x0, x0 + pw);
+                        }
+                        grid[ty * gridCols + tx] = total;
+                    } else if (s < T) {
+                        live.resize(w);
+                        for (uint64_t y = 0; y < ph; ++y) {
+                            uint64_t r0 = (y0 + y) << shift, r1 = std::min(rows, r0 + s);
+                            std::fill(live.begin(), live.end(), 0);
+                            for (uint64_t r = r0; r < r1; ++r) {
+                                const uint64_t *words = rowWords(r);
+                                uint64_t x = 0;
+                                if (s <= 64) {  // each pixel is one aligned field of one word
+                                    const uint64_t field = s == 64 ? ~0ull : (1ull << s) - 1;
+                                    for (; x < pw && ((x0 + x + 1) << shift) <= cols; ++x) {
+                                        uint64_t c0 = (x0 + x) << shift;
+                                        live[x] += __builtin_popcountll(words[c0 >> 6] >> (c0 & 63) & field);
+                                    }
+                                }
+                                for (; x < pw; ++x) {
+                                    uint64_t c0 = (x0 + x) << shift;
+                                    live[x] += countRowBits(words, c0, std::min(cols, c0 + s));
+                                }
+                            }
+                            uint8_t *dst = &raw[y * stride + 1];
+                            for (uint64_t x = 0; x < pw; ++x) {
+                                uint64_t c0 = (x0 + x) << shift;
+                                dst[x] = pyramidShade(live[x], (r1 - r0) * (std::min(cols, c0 + s) - c0));
+                            }
+                        }
+                    } else {
+                        const uint64_t g = s / T;  // grid blocks per pixel, each way
+                        for (uint64_t y = 0; y < ph; ++y) {
+                            uint64_t gy0 = (y0 + y) * g, gy1 = std::min(gridRows, gy0 + g);
+                            uint64_t r0 = (y0 + y) << shift, r1 = std::min(rows, r0 + s);
+                            uint8_t *dst = &raw[y * stride + 1];
+                            for (uint64_t x = 0; x < pw; ++x) {
+                                uint64_t gx0 = (x0 + x) * g, gx1 = std::min(gridCols, gx0 + g), n = 0;
+                                for (uint64_t gy = gy0; gy < gy1; ++gy)
+                                    for (uint64_t gx = gx0; gx < gx1; ++gx) n += grid[gy * gridCols + gx];
+                                uint64_t c0 = (x0 + x) << shift;
+                                dst[x] = pyramidShade(n, (r1 - r0) * (std::min(cols, c0 + s) - c0));
+                            }
+                        }
+                    }
+
+                    fs::path path = opt.xyz ? levelDir / std::to_string(tx) / (std::to_string(ty) + ".png")
+                                            : levelDir / (std::to_string(tx) + "_" + std::to_string(ty) + ".png");
+                    if (!encodePng(raw, w, h, depth, opt.compression, png)) fail("zlib failed on " + path.string());
+                    else if (!writeTileFile(path, png)) fail("cannot write " + path.string());
+                });
+            pool.waitAll();
+        }
+    }
+    if (failed) return false;
+
+    if (!opt.xyz) {
+        std::ofstream dzi(out + ".dzi");
+        dzi << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" Format=\"png\" Overlap=\"0\" TileSize=\""
+            << T << "\">\n"
+            << "  <Size Width=\"" << cols << "\" Height=\"" << rows << "\"/>\n"
+            << "</Image>\n";
+        if (!dzi) {
+            if (error) *error = "cannot write " + out + ".dzi";
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool exportTilePyramid(ThreadPool &pool, const MappedSnapshot &snap, const std::string &out,
+                              const TilePyramidOptions &opt = {}, std::string *error = nullptr) {
+    return exportTilePyramid(pool, snap.header().rows, snap.header().cols,
+                             [&](uint64_t r) { return snap.row((uint32_t)r); }, out, opt, error);
+}
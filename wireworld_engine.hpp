@@ -0,0 +1,241 @@
+#pragma once
+#include "life_accel.hpp"
+#include "pattern_store.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// ---------- Wireworld Engine ----------
+//
+// Wireworld cells are empty, copper, electron head or electron tail. Heads
+// become tails, tails become copper, and copper becomes a head when one or
+// two of its eight neighbours are heads. Copper never changes, so the engine
+// numbers the non-empty cells once, in row-major order, and stores each
+// one's non-empty neighbours as index lists (one offset per cell into a
+// shared array). A step touches only the current heads and tails and their
+// neighbours:
+//   1. every head adds one to a counter on each neighbour, and the first
+//      increment records the neighbour as a candidate;
+//   2. candidates that are plain copper with a count of 1 or 2 become the
+//      new heads;
+//   3. old tails turn back into copper, and old heads become tails.
+// So a step costs O(heads), whatever the circuit's area. Long head lists are
+// split across the ThreadPool, and the counters are bumped atomically.
+//
+// The board is a byte-per-cell row-major grid like LifeAccel's, holding the
+// state in each byte, so it renders the same way. Editing cells marks the
+// neighbour lists stale, and the next step rebuilds them.
+//
+enum WireState : uint8_t { kWireEmpty = 0, kWireHead = 1, kWireTail = 2, kWireCopper = 3 };  // Golly's numbering
+
+class WireWorld {
+public:
+    WireWorld(int cols, int rows, ThreadPool &pool)
+        : rows(rows), cols(cols), cells((size_t)rows * cols, kWireEmpty), pool(pool) {}
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    uint8_t get(int r, int c) const { return cells[(size_t)r * cols + c]; }
+    void set(int r, int c, uint8_t s) {
+        cells[(size_t)r * cols + c] = s;
+        graphValid = false;
+    }
+    const uint8_t *data() const { return cells.data(); }
+
+    // Copies `pr` x `pc` states (row-major) with their top-left at (top, left),
+    // clipped to the board.
+    void stamp(const std::vector<uint8_t> &states, uint32_t pr, uint32_t pc, int top, int left) {
+        for (uint32_t i = 0; i < pr; ++i)
+            for (uint32_t j = 0; j < pc; ++j) {
+                int r = top + (int)i, c = left + (int)j;
+                if (r >= 0 && r < rows && c >= 0 && c < cols) cells[(size_t)r * cols + c] = states[(size_t)i * pc + j];
+            }
+        graphValid = false;
+    }
+
+    void step() {
+        if (!graphValid) compile();
+        auto t0 = std::chrono::steady_clock::now();
+
+        const size_t chunks = heads.size() >= kParallelHeads ? std::max<size_t>(1, pool.size()) * 4 : 1;
+        candidates.resize(chunks);
+        born.resize(chunks);
+        auto chunkRange = [&](const std::vector<uint32_t> &v, size_t k, size_t &b, size_t &e) {
+            b = v.size() * k / chunks;
+            e = v.size() * (k + 1) / chunks;
+        };
+        auto count = [&](size_t k) {
+            std::vector<uint32_t> &cand = candidates[k];
+            cand.clear();
+            size_t b, e;
+            chunkRange(heads, k, b, e);
+            for (size_t i = b; i < e; ++i)
+                for (uint32_t a = offset[heads[i]]; a < offset[heads[i] + 1]; ++a) {
+                    uint32_t n = adj[a];
+                    bool first = chunks == 1 ? hits[n]++ == 0 : __atomic_fetch_add(&hits[n], 1, __ATOMIC_RELAXED) == 0;
+                    if (first) cand.push_back(n);
+                }
+        };
+        // every candidate sits in exactly one chunk's list, so its counter is
+        // read and cleared by one worker only
+        auto select = [&](size_t k) {
+            born[k].clear();
+            for (uint32_t n : candidates[k]) {
+                if (state[n] == kWireCopper && hits[n] <= 2) born[k].push_back(n);
+                hits[n] = 0;
+            }
+        };
+        if (chunks == 1) {
+            count(0);
+            select(0);
+        } else {
+            for (size_t k = 0; k < chunks; ++k) pool.enqueue([&, k] { count(k); });
+            pool.waitAll();
+            for (size_t k = 0; k < chunks; ++k) pool.enqueue([&, k] { select(k); });
+            pool.waitAll();
+        }
+
+        for (uint32_t t : tails) setState(t, kWireCopper);
+        for (uint32_t h : heads) setState(h, kWireTail);
+        tails.swap(heads);
+        heads.clear();
+        for (auto &list : born)
+            for (uint32_t n : list) {
+                setState(n, kWireHead);
+                heads.push_back(n);
+            }
+        generation++;
+        stepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    long long getGeneration() const { return generation; }
+    double getStepMs() const { return stepMs; }
+    size_t getHeadCount() {
+        if (!graphValid) compile();
+        return heads.size();
+    }
+    size_t getConductorCount() {
+        if (!graphValid) compile();
+        return state.size();
+    }
+
+    // Rendering lives with the SFML front end (main.cpp). Copper never
+    // changes, so it is appended once; signals are appended every frame.
+    void appendCopper(sf::VertexArray &va, float cellSize) const;
+    void appendSignals(sf::VertexArray &va, float cellSize) const;
+
+private:
+    static constexpr size_t kParallelHeads = 1 << 15;
+
+    int rows, cols;
+    std::vector<uint8_t, ZeroPageAllocator<uint8_t>> cells;
+    ThreadPool &pool;
+    bool graphValid = false;
+    long long generation = 0;
+    double stepMs = 0;
+
+    // per non-empty cell, in row-major order
+    std::vector<size_t> where;      // grid index
+    std::vector<uint8_t> state;     // WireState
+    std::vector<uint8_t> hits;      // head neighbours, during a step
+    std::vector<uint32_t> offset;   // neighbours of cell i: adj[offset[i] .. offset[i + 1])
+    std::vector<uint32_t> adj;
+    std::vector<uint32_t> heads, tails;
+    std::vector<std::vector<uint32_t>> candidates, born;  // per chunk
+
+    void setState(uint32_t i, uint8_t s) {
+        state[i] = s;
+        cells[where[i]] = s;
+    }
+
+    // Numbers the non-empty cells and links each to its non-empty neighbours.
+    // A neighbour's number is found by binary search within its row, so the
+    // build needs no per-cell index grid.
+    void compile() {
+        where.clear();
+        std::vector<uint32_t> rowStart(rows + 1);
+        for (int r = 0; r < rows; ++r) {
+            rowStart[r] = (uint32_t)where.size();
+            const uint8_t *row = &cells[(size_t)r * cols];
+            for (int c = 0; c < cols; ++c)
+                if (row[c] != kWireEmpty) where.push_back((size_t)r * cols + c);
+        }
+        rowStart[rows] = (uint32_t)where.size();
+
+        const size_t n = where.size();
+        state.resize(n);
+        hits.assign(n, 0);
+        offset.assign(n + 1, 0);
+        adj.clear();
+        heads.clear();
+        tails.clear();
+        for (size_t i = 0; i < n; ++i) {
+            state[i] = cells[where[i]];
+            if (state[i] == kWireHead) heads.push_back((uint32_t)i);
+            if (state[i] == kWireTail) tails.push_back((uint32_t)i);
+            int r = (int)(where[i] / cols), c = (int)(where[i] % cols);
+            for (int dr = -1; dr <= 1; ++dr) {
+                int rr = r + dr;
+                if (rr < 0 || rr >= rows) continue;
+                auto b = where.begin() + rowStart[rr], e = where.begin() + rowStart[rr + 1];
+                size_t lo = (size_t)rr * cols + std::max(0, c - 1), hi = (size_t)rr * cols + std::min(cols - 1, c + 1);
+                for (auto it = std::lower_bound(b, e, lo); it != e && *it <= hi; ++it)
+                    if (*it != where[i]) adj.push_back((uint32_t)(it - where.begin()));
+            }
+            offset[i + 1] = (uint32_t)adj.size();
+        }
+        graphValid = true;
+    }
+};
+
+// Reads a Golly Wireworld RLE: "x = , y =" header, then runs of '.' (empty),
+// 'A' (head), 'B' (tail), 'C' (copper), '$' and '!'.
+inline bool parseWireworldRle(const std::string &text, std::vector<uint8_t> &states, uint32_t &rows, uint32_t &cols,
+                              std::string *error = nullptr) {
+    const char *p = text.data(), *end = p + text.size();
+    unsigned long long w = 0, h = 0;
+    bool header = false;
+    while (p < end && !header) {
+        const char *eol = std::find(p, end, '\n');
+        std::string line(p, eol);
+        p = eol < end ? eol + 1 : end;
+        if (line.empty() || line[0] == '#') continue;
+        if (std::sscanf(line.c_str(), " x = %llu , y = %llu", &w, &h) != 2)
+            return patternFail(error, "RLE: missing \"x = , y =\" header");
+        header = true;
+    }
+    if (!header) return patternFail(error, "RLE: missing header");
+    if (w >= UINT32_MAX || h >= UINT32_MAX || w * h > kMaxPatternBytes)
+        return patternFail(error, "RLE: pattern too large");
+    rows = (uint32_t)h;
+    cols = (uint32_t)w;
+    states.assign((size_t)w * h, kWireEmpty);
+
+    uint64_t r = 0, c = 0, count = 0;
+    for (; p < end && *p != '!'; ++p) {
+        char ch = *p;
+        if (ch >= '0' && ch <= '9') {
+            count = count * 10 + (ch - '0');
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') continue;
+        uint64_t k = count ? count : 1;
+        count = 0;
+        if (ch == '$') {
+            r += k;
+            c = 0;
+        } else if (ch == '.' || ch == 'b') {
+            c += k;
+        } else if (ch >= 'A' && ch <= 'C') {
+            if (r >= h || c + k > w) return patternFail(error, "RLE: cells outside the x/y header");
+            std::fill_n(&states[r * w + c], k, (uint8_t)(ch - 'A' + 1));
+            c += k;
+        } else {
+            return patternFail(error, std::string("RLE: '") + ch + "' is not a Wireworld state");
+        }
+    }
+    return true;
+}